@@ -0,0 +1,154 @@
+#include <math.h>
+
+#include <OsirisSDK/GLdefs.h>
+#include <OsirisSDK/OCamera.h>
+
+#include "BenchSimulation.h"
+
+#define BENCHSIMULATION_WIDTH	640
+#define BENCHSIMULATION_HEIGHT	480
+
+BenchSimulation::BenchSimulation(int argc, char **argv) :
+	OSimulation("OsirisBench", argc, argv, 0, 0, BENCHSIMULATION_WIDTH, BENCHSIMULATION_HEIGHT),
+	_cube(NULL)
+{
+}
+
+BenchSimulation::~BenchSimulation()
+{
+	destroyEntities();
+	if (_cube) delete _cube;
+}
+
+void BenchSimulation::init()
+{
+}
+
+void BenchSimulation::runScenarios(Benchmark * bench)
+{
+	camera()->setPosition(OVector3(0.0f, 20.0f, 40.0f));
+	camera()->setOrientation(OVector3(-30.0f, 0.0f, 0.0f));
+	camera()->setCameraLimits(1.0f, 200.0f);
+
+	/* same cube as the demo table */
+	_cube = new OVertexColorMesh();
+	_cube->addVertexData(-0.5f, -0.5f, -0.5f);
+	_cube->addVertexData(-0.5f, -0.5f, 0.5f);
+	_cube->addVertexData(-0.5f, 0.5f, -0.5f);
+	_cube->addVertexData(-0.5f, 0.5f, 0.5f);
+	_cube->addVertexData(0.5f, -0.5f, -0.5f);
+	_cube->addVertexData(0.5f, -0.5f, 0.5f);
+	_cube->addVertexData(0.5f, 0.5f, -0.5f);
+	_cube->addVertexData(0.5f, 0.5f, 0.5f);
+	for (int i = 0; i < 8; i++) _cube->addVertexColorData(0.2f + 0.1f * i, 0.5f, 1.0f - 0.1f * i, 1.0f);
+	_cube->addIndexData(0, 4, 1);
+	_cube->addIndexData(1, 2, 0);
+	_cube->addIndexData(1, 4, 5);
+	_cube->addIndexData(1, 7, 3);
+	_cube->addIndexData(2, 4, 0);
+	_cube->addIndexData(2, 7, 6);
+	_cube->addIndexData(3, 2, 1);
+	_cube->addIndexData(3, 7, 2);
+	_cube->addIndexData(4, 7, 5);
+	_cube->addIndexData(5, 7, 1);
+	_cube->addIndexData(6, 4, 2);
+	_cube->addIndexData(6, 7, 4);
+	_cube->setFaceCulling(true, OMesh::CullFace_Front, OMesh::CullFront_CW);
+	_cube->init();
+
+	benchUpdate(bench, 100);
+	benchUpdate(bench, 1000);
+	benchUpdate(bench, 10000);
+
+	benchRender(bench, 100);
+	benchRender(bench, 1000);
+	benchRender(bench, 10000);
+}
+
+void BenchSimulation::createEntities(int count)
+{
+	/* entities laid on a square grid, each one moving and spinning at its own pace */
+	int side = (int)ceil(sqrt((double)count));
+	for (int i = 0; i < count; i++) {
+		OEntity* entity = new OEntity(NULL, NULL, _cube);
+		OState* state = entity->state()->curr();
+		state->position() = OVector3(40.0f * (i % side) / side - 20.0f, 0.0f, 40.0f * (i / side) / side - 20.0f);
+		state->scale() = OVector3(20.0f / side);
+		state->setMotionComponent(1, OVector3(0.0f, 0.01f * (i % 7), 0.0f) / 1e6, OState::Scene);
+		state->setOrientation(OVector3(0.0f, 3.6f * (i % 100), 0.0f));
+		entities()->add(entity);
+		_benchEntities.push_back(entity);
+	}
+}
+
+void BenchSimulation::destroyEntities()
+{
+	for (size_t i = 0; i < _benchEntities.size(); i++) {
+		entities()->remove(_benchEntities[i]);
+		delete _benchEntities[i];
+	}
+	_benchEntities.clear();
+}
+
+void BenchSimulation::benchUpdate(Benchmark * bench, int count)
+{
+	if (!bench->selected("OSimulation::update") && !bench->selected("OSimulation::equalizeState") &&
+	    !bench->selected("OSimulation::updateState") && !bench->selected("OSimulation::swapState")) return;
+
+	createEntities(count);
+	OTimeIndex timeIndex;
+	bench->run("scenario", "OSimulation::update", count, count, [&]() {
+		timeIndex += OAPPLICATION_DEFAULT_SIMULATIONSTEP;
+		update(timeIndex, OAPPLICATION_DEFAULT_SIMULATIONSTEP);
+	});
+
+	/* each phase on its own, so that a regression can be traced to one of them */
+	bench->run("scenario", "OSimulation::equalizeState", count, count, [&]() {
+		equalizeStates();
+	});
+	bench->run("scenario", "OSimulation::updateState", count, count, [&]() {
+		timeIndex += OAPPLICATION_DEFAULT_SIMULATIONSTEP;
+		updateStates(timeIndex, OAPPLICATION_DEFAULT_SIMULATIONSTEP);
+	});
+	bench->run("scenario", "OSimulation::swapState", count, count, [&]() {
+		timeIndex += OAPPLICATION_DEFAULT_SIMULATIONSTEP;
+		swapStates(timeIndex, OAPPLICATION_DEFAULT_SIMULATIONSTEP);
+	});
+	destroyEntities();
+}
+
+void BenchSimulation::benchRender(Benchmark * bench, int count)
+{
+	if (!bench->selected("OSimulation::render") && !bench->selected("OSimulation::renderNonInstanced") &&
+	    !bench->selected("OSimulation::frame")) return;
+
+	createEntities(count);
+
+	/* glFinish() makes the measurement include the GPU (or software rasterizer) work */
+	bench->run("scenario", "OSimulation::render", count, count, [&]() {
+		clearScreen();
+		render();
+		glFinish();
+	});
+
+	/* one draw call per entity, for comparison */
+	setInstancedRendering(false);
+	bench->run("scenario", "OSimulation::renderNonInstanced", count, count, [&]() {
+		clearScreen();
+		render();
+		glFinish();
+	});
+	setInstancedRendering(true);
+
+	OTimeIndex timeIndex;
+	bench->run("scenario", "OSimulation::frame", count, 1, [&]() {
+		timeIndex += OAPPLICATION_DEFAULT_SIMULATIONSTEP;
+		clearScreen();
+		update(timeIndex, OAPPLICATION_DEFAULT_SIMULATIONSTEP);
+		render();
+		glutSwapBuffers();
+		glFinish();
+	});
+
+	destroyEntities();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include <OsirisSDK/OSimulation.h>
+#include <OsirisSDK/OEntity.h>
+#include <OsirisSDK/OVertexColorMesh.h>
+
+#include "Benchmark.h"
+
+/**
+ @brief Simulation used by the scenario benchmarks.
+
+ The benchmarks drive the simulation update and render phases directly, outside of the GLUT main loop, over a
+ varying number of entities. A GL context is required: on machines without a GPU, Mesa's software rasterizer can
+ be used through a virtual X server (i.e. xvfb-run with LIBGL_ALWAYS_SOFTWARE=1).
+ */
+class BenchSimulation : public OSimulation
+{
+public:
+	BenchSimulation(int argc, char **argv);
+	~BenchSimulation();
+
+	virtual void init() override;
+
+	/**
+	 @brief Runs the scenario benchmarks.
+	 */
+	void runScenarios(Benchmark* bench);
+
+private:
+	OVertexColorMesh* _cube;
+	std::vector<OEntity*> _benchEntities;
+
+	void createEntities(int count);
+	void destroyEntities();
+	void benchUpdate(Benchmark* bench, int count);
+	void benchRender(Benchmark* bench, int count);
+};
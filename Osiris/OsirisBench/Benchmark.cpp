@@ -0,0 +1,122 @@
+#include <time.h>
+#include <math.h>
+#include <algorithm>
+
+#include <OsirisSDK/OTimeIndex.h>
+
+#include "Benchmark.h"
+
+using namespace std;
+
+static const void* volatile _keepSink = NULL;
+
+/* nearest-rank percentile of sorted samples */
+static double percentile(const vector<double>& sorted, double p)
+{
+	size_t rank = (size_t)ceil(p / 100.0 * sorted.size());
+	if (rank < 1) rank = 1;
+	if (rank > sorted.size()) rank = sorted.size();
+	return sorted[rank - 1];
+}
+
+Benchmark::Benchmark(int warmup, int iterations, const char* filter) :
+	_warmup(warmup),
+	_iterations((iterations > 0) ? iterations : 1),
+	_filter((filter) ? filter : "")
+{
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+void Benchmark::run(const char * group, const char * name, int param, int opsPerIteration, const Body & body)
+{
+	if (!selected(name)) return;
+	if (opsPerIteration < 1) opsPerIteration = 1;
+
+	for (int i = 0; i < _warmup; i++) body();
+
+	vector<double> samples;
+	samples.reserve(_iterations);
+	for (int i = 0; i < _iterations; i++) {
+		long long start = OTimeIndex::ticks();
+		body();
+		long long end = OTimeIndex::ticks();
+		samples.push_back((double)OTimeIndex::ticksToNanoseconds(end - start) / opsPerIteration);
+	}
+
+	Result result;
+	result.group = group;
+	result.name = name;
+	result.param = param;
+	result.opsPerIteration = opsPerIteration;
+	result.iterations = _iterations;
+
+	double sum = 0.0;
+	for (size_t i = 0; i < samples.size(); i++) sum += samples[i];
+	result.mean = sum / samples.size();
+	double m2 = 0.0;
+	for (size_t i = 0; i < samples.size(); i++) m2 += (samples[i] - result.mean) * (samples[i] - result.mean);
+	result.stdev = (samples.size() > 1) ? sqrt(m2 / (samples.size() - 1)) : 0.0;
+
+	sort(samples.begin(), samples.end());
+	result.minValue = samples.front();
+	result.p50 = percentile(samples, 50);
+	result.p90 = percentile(samples, 90);
+	result.p99 = percentile(samples, 99);
+	result.maxValue = samples.back();
+
+	_results.push_back(result);
+	printResult(stderr, result);
+}
+
+bool Benchmark::selected(const char * name) const
+{
+	return (_filter.empty() || string(name).find(_filter) != string::npos);
+}
+
+const vector<Benchmark::Result>& Benchmark::results() const
+{
+	return _results;
+}
+
+void Benchmark::writeJSON(FILE * fp) const
+{
+	fprintf(fp, "{\n");
+	fprintf(fp, "\t\"format\": \"osiris-bench\",\n");
+	fprintf(fp, "\t\"version\": 1,\n");
+	fprintf(fp, "\t\"timestamp\": %lld,\n", (long long)time(NULL));
+#ifdef NDEBUG
+	fprintf(fp, "\t\"build\": \"release\",\n");
+#else
+	fprintf(fp, "\t\"build\": \"debug\",\n");
+#endif
+	fprintf(fp, "\t\"clock\": \"%s\",\n", (OTimeIndex::isTSCClock()) ? "tsc" : "monotonic");
+	fprintf(fp, "\t\"unit\": \"ns/op\",\n");
+	fprintf(fp, "\t\"warmup\": %d,\n", _warmup);
+	fprintf(fp, "\t\"iterations\": %d,\n", _iterations);
+	fprintf(fp, "\t\"benchmarks\": [");
+	for (size_t i = 0; i < _results.size(); i++) {
+		const Result& r = _results[i];
+		fprintf(fp, "%s\n\t\t{\"group\": \"%s\", \"name\": \"%s\", \"param\": %d, \"opsPerIteration\": %d, "
+			"\"iterations\": %d, \"mean\": %.3f, \"stdev\": %.3f, \"min\": %.3f, \"p50\": %.3f, "
+			"\"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+			(i > 0) ? "," : "", r.group.c_str(), r.name.c_str(), r.param, r.opsPerIteration, r.iterations,
+			r.mean, r.stdev, r.minValue, r.p50, r.p90, r.p99, r.maxValue);
+	}
+	fprintf(fp, "\n\t]\n}\n");
+}
+
+void Benchmark::printResult(FILE * fp, const Result & result)
+{
+	char label[128];
+	snprintf(label, sizeof(label), "%s/%s/%d", result.group.c_str(), result.name.c_str(), result.param);
+	fprintf(fp, "%-48s %12.1f ns/op  (p50 %.1f, p99 %.1f, stdev %.1f)\n",
+		label, result.mean, result.p50, result.p99, result.stdev);
+}
+
+void Benchmark::keep(const void * ptr)
+{
+	_keepSink = ptr;
+}
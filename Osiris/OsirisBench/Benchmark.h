@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARK_DEFAULT_WARMUP
+#define BENCHMARK_DEFAULT_WARMUP	5
+#endif
+
+#ifndef BENCHMARK_DEFAULT_ITERATIONS
+#define BENCHMARK_DEFAULT_ITERATIONS	30
+#endif
+
+/**
+ @brief Benchmark suite: registers benchmarks, runs them and writes the results as JSON.
+
+ Every benchmark follows the same protocol. Its body runs a fixed number of operations per call (an iteration).
+ The body is first called a number of warmup times, which are not measured, so caches, allocators and drivers
+ reach a steady state; then it is called the configured number of iterations, each one timed separately. The
+ statistics are computed over the per-operation times of the measured iterations, in nanoseconds.
+ */
+class Benchmark
+{
+public:
+	/**
+	 @brief Benchmark body. Runs one iteration.
+	 */
+	typedef std::function<void()> Body;
+
+	/**
+	 @brief Statistics of a benchmark run, in nanoseconds per operation.
+	 */
+	struct Result {
+		std::string group;
+		std::string name;
+		int param;
+		int opsPerIteration;
+		int iterations;
+		double mean;
+		double stdev;
+		double minValue;
+		double p50;
+		double p90;
+		double p99;
+		double maxValue;
+	};
+
+	/**
+	 @brief Class constructor.
+	 @param warmup Number of unmeasured iterations run before measuring.
+	 @param iterations Number of measured iterations.
+	 @param filter If not NULL, only benchmarks whose name contains this string are run.
+	 */
+	Benchmark(int warmup=BENCHMARK_DEFAULT_WARMUP, int iterations=BENCHMARK_DEFAULT_ITERATIONS,
+		  const char* filter=NULL);
+
+	/**
+	 @brief Class destructor.
+	 */
+	virtual ~Benchmark();
+
+	/**
+	 @brief Runs a benchmark and stores its result, unless it is excluded by the filter.
+	 @param group Benchmark group ("micro" or "scenario").
+	 @param name Benchmark name.
+	 @param param Benchmark parameter (i.e. entity count), or zero.
+	 @param opsPerIteration Number of operations performed by each call to the body.
+	 @param body Benchmark body.
+	 */
+	void run(const char* group, const char* name, int param, int opsPerIteration, const Body& body);
+
+	/**
+	 @brief Returns true if a benchmark is selected by the filter.
+	 */
+	bool selected(const char* name) const;
+
+	/**
+	 @brief Returns the results collected so far.
+	 */
+	const std::vector<Result>& results() const;
+
+	/**
+	 @brief Writes the run configuration and the results as a JSON document.
+	 */
+	void writeJSON(FILE* fp) const;
+
+	/**
+	 @brief Writes a human readable summary of a result.
+	 */
+	static void printResult(FILE* fp, const Result& result);
+
+	/**
+	 @brief Keeps the compiler from optimizing away a computation whose result is otherwise unused.
+	 */
+	static void keep(const void* ptr);
+
+private:
+	int _warmup;
+	int _iterations;
+	std::string _filter;
+	std::vector<Result> _results;
+};
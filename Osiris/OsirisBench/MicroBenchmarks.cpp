@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <vector>
+
+#include <OsirisSDK/OState.h>
+#include <OsirisSDK/OCollection.hpp>
+#include <OsirisSDK/OMemoryPool.h>
+#include <OsirisSDK/OMatrixStack.h>
+#include <OsirisSDK/OMesh.h>
+#include <OsirisSDK/OWavefrontObjectFile.h>
+
+#include "MicroBenchmarks.h"
+
+#ifndef BENCHMARK_MESHFILE
+#define BENCHMARK_MESHFILE	"OsirisBench.mesh.obj"
+#endif
+
+using namespace std;
+
+static void benchState(Benchmark* bench)
+{
+	const int ops = 1000;
+	OState state;
+	state.setMotionComponent(1, OVector3(0.3f, 0.0f, 0.3f) / 1e6, OState::Object);
+	state.setMotionComponent(2, OVector3(0.0f, -9.8f, 0.0f) / 1e12, OState::Scene);
+	state.maxConstraint(1)->setValue(OVector3::X, true, 1.0f / 1e6);
+	OTimeIndex timeIndex;
+
+	bench->run("micro", "OState::update", 0, ops, [&]() {
+		for (int i = 0; i < ops; i++) {
+			timeIndex += 1000;
+			state.update(timeIndex, 1000);
+		}
+		Benchmark::keep(&state.position());
+	});
+}
+
+static void benchCollection(Benchmark* bench, int count)
+{
+	vector<int> items(count);
+	OCollection<int> collection;
+
+	bench->run("micro", "OCollection::addRemove", count, count, [&]() {
+		for (int i = 0; i < count; i++) collection.add(&items[i]);
+		for (int i = 0; i < count; i++) collection.remove(&items[i]);
+	});
+
+	for (int i = 0; i < count; i++) collection.add(&items[i]);
+	bench->run("micro", "OCollection::iterate", count, count, [&]() {
+		int sum = 0;
+		for (OCollection<int>::Iterator it = collection.begin(); it != collection.end(); it++) {
+			sum += *it.object();
+		}
+		Benchmark::keep(&sum);
+	});
+}
+
+static void benchMemoryPool(Benchmark* bench, int count)
+{
+	OMemoryPool pool(64, 1024);
+	vector<void*> blocks(count);
+
+	bench->run("micro", "OMemoryPool::allocFree", count, count, [&]() {
+		for (int i = 0; i < count; i++) blocks[i] = pool.alloc(64);
+		for (int i = count - 1; i >= 0; i--) pool.free(blocks[i]);
+	});
+
+	/* events are released in the order they were created */
+	bench->run("micro", "OMemoryPool::allocFreeFIFO", count, count, [&]() {
+		for (int i = 0; i < count; i++) blocks[i] = pool.alloc(64);
+		for (int i = 0; i < count; i++) pool.free(blocks[i]);
+	});
+}
+
+static void benchMatrixStack(Benchmark* bench, int depth)
+{
+	const int ops = 100;
+	OMatrixStack stack;
+	stack.perspective(45.0f, 4.0f / 3.0f, 1.0f, 100.0f);
+	stack.camera(OVector3(3.0f, 1.5f, 7.0f), OVector3(-3.0f, -1.5f, -7.0f));
+	OQuaternion orientation(OVector3(0.0f, 1.0f, 0.0f), 0.5f);
+
+	bench->run("micro", "OMatrixStack::transformChain", depth, ops, [&]() {
+		for (int i = 0; i < ops; i++) {
+			for (int j = 0; j < depth; j++) {
+				stack.push();
+				stack.translate(0.1f, 0.2f, 0.3f);
+				stack *= orientation;
+				stack.scale(1.01f);
+			}
+			OVector4 v = stack * OVector4(1.0f, 1.0f, 1.0f, 1.0f);
+			Benchmark::keep(&v);
+			for (int j = 0; j < depth; j++) stack.pop();
+		}
+	});
+}
+
+static void benchWavefront(Benchmark* bench, int gridSize)
+{
+	/* a single object: a grid of gridSize x gridSize vertices, two triangles per cell */
+	FILE *fp;
+#ifdef WIN32
+	fopen_s(&fp, BENCHMARK_MESHFILE, "wb");
+#else
+	fp = fopen(BENCHMARK_MESHFILE, "wb");
+#endif
+	if (!fp) {
+		fprintf(stderr, "Unable to write '%s', skipping mesh parsing benchmark.\n", BENCHMARK_MESHFILE);
+		return;
+	}
+	fprintf(fp, "# OsirisBench generated mesh\no Grid\n");
+	for (int i = 0; i < gridSize; i++) {
+		for (int j = 0; j < gridSize; j++) {
+			fprintf(fp, "v %f %f %f\n", (float)i / gridSize, 0.01f * ((i * 7 + j * 13) % 17), (float)j / gridSize);
+		}
+	}
+	for (int i = 0; i < gridSize - 1; i++) {
+		for (int j = 0; j < gridSize - 1; j++) {
+			int a = i * gridSize + j + 1;
+			fprintf(fp, "f %d/%d %d/%d %d/%d\n", a, a, a + 1, a + 1, a + gridSize, a + gridSize);
+			fprintf(fp, "f %d %d %d\n", a + 1, a + gridSize + 1, a + gridSize);
+		}
+	}
+	fclose(fp);
+
+	int vertexCount = gridSize * gridSize;
+	bench->run("micro", "OWavefrontObjectFile::loadMesh", vertexCount, 1, [&]() {
+		OWavefrontObjectFile file(BENCHMARK_MESHFILE);
+		int objectCount = 0;
+		const char** objectList = file.objectList(&objectCount);
+		OMesh mesh;
+		if (objectCount > 0) file.loadMesh(objectList[0], &mesh);
+		Benchmark::keep(&mesh);
+	});
+
+	remove(BENCHMARK_MESHFILE);
+}
+
+void runMicroBenchmarks(Benchmark* bench)
+{
+	benchState(bench);
+
+	benchCollection(bench, 100);
+	benchCollection(bench, 10000);
+
+	benchMemoryPool(bench, 100);
+	benchMemoryPool(bench, 1000);
+
+	benchMatrixStack(bench, 1);
+	benchMatrixStack(bench, 8);
+
+	if (bench->selected("OWavefrontObjectFile::loadMesh")) {
+		benchWavefront(bench, 100);
+		benchWavefront(bench, 300);
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Benchmark.h"
+
+/**
+ @brief Runs the benchmarks that don't need a GL context: state integration, collections, memory pool, matrix
+	stack and mesh file parsing.
+ */
+void runMicroBenchmarks(Benchmark* bench);
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OsirisSDK/OException.h>
+
+#include "Benchmark.h"
+#include "MicroBenchmarks.h"
+#include "BenchSimulation.h"
+
+static void usage(const char* argv0)
+{
+	fprintf(stderr, "Usage: %s [-o output.json] [-w warmup] [-n iterations] [-f filter] [-micro | -scenario]\n"
+			"  -o         JSON output file (default: standard output)\n"
+			"  -w         unmeasured warmup iterations (default: %d)\n"
+			"  -n         measured iterations (default: %d)\n"
+			"  -f         only run benchmarks whose name contains the filter\n"
+			"  -micro     only run the micro benchmarks (no GL context needed)\n"
+			"  -scenario  only run the scenario benchmarks\n",
+			argv0, BENCHMARK_DEFAULT_WARMUP, BENCHMARK_DEFAULT_ITERATIONS);
+}
+
+int main(int argc, char** argv)
+{
+	const char* output = NULL;
+	const char* filter = NULL;
+	int warmup = BENCHMARK_DEFAULT_WARMUP;
+	int iterations = BENCHMARK_DEFAULT_ITERATIONS;
+	bool micro = true;
+	bool scenario = true;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-o") && i + 1 < argc) output = argv[++i];
+		else if (!strcmp(argv[i], "-w") && i + 1 < argc) warmup = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-n") && i + 1 < argc) iterations = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-f") && i + 1 < argc) filter = argv[++i];
+		else if (!strcmp(argv[i], "-micro")) scenario = false;
+		else if (!strcmp(argv[i], "-scenario")) micro = false;
+		else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	Benchmark bench(warmup, iterations, filter);
+	try {
+		if (micro) runMicroBenchmarks(&bench);
+		if (scenario) {
+			BenchSimulation app(argc, argv);
+			app.runScenarios(&bench);
+		}
+	}
+	catch (OException &e) {
+		fprintf(stderr, "[Exception caught] %s\n", e.what());
+		return 1;
+	}
+
+	FILE *fp = stdout;
+	if (output) {
+#ifdef WIN32
+		fopen_s(&fp, output, "wb");
+#else
+		fp = fopen(output, "wb");
+#endif
+		if (!fp) {
+			fprintf(stderr, "Unable to write '%s'.\n", output);
+			return 1;
+		}
+	}
+	bench.writeJSON(fp);
+	if (fp != stdout) fclose(fp);
+
+	return 0;
+}
@@ -1,6 +1,7 @@
 #include <OsirisSDK/OVertexColorMesh.h>
 #include <OsirisSDK/OWavefrontObjectFile.h>
 #include <OsirisSDK/OParameterList.h>
+#include <OsirisSDK/OGPUTimer.h>
 
 #include "DemoSimulation.h"
 #include "PieceBehavior.h"
@@ -105,11 +106,11 @@ void DemoSimulation::init()
 
 	/* creating moving piece */
 	PieceBehavior *behavior = new PieceBehavior();
-	OParameterList *attributeList = new OParameterList(4);
-	(*attributeList)[PieceBehavior::attrMinX] = -1.5f;
-	(*attributeList)[PieceBehavior::attrMinZ] = -3.5f;
-	(*attributeList)[PieceBehavior::attrMaxX] = 1.5f;
-	(*attributeList)[PieceBehavior::attrMaxZ] = 3.5f;
+	OParameterList *attributeList = new OParameterList(PieceBehavior::attributeSchema());
+	attributeList->setVal(PieceBehavior::attrMinX, -1.5f);
+	attributeList->setVal(PieceBehavior::attrMinZ, -3.5f);
+	attributeList->setVal(PieceBehavior::attrMaxX, 1.5f);
+	attributeList->setVal(PieceBehavior::attrMaxZ, 3.5f);
 	_movingPiece = new OEntity(attributeList, behavior, torus);
 	_movingPiece->state()->curr()->position() = OVector3(0.0f, 0.0f, 0.0f);
 	_movingPiece->state()->curr()->setMotionComponent(1, OVector3(0.3f, 0.0f, 0.3f) / 1e6, OState::Object);
@@ -120,11 +121,13 @@ void DemoSimulation::init()
 	_fontCourier = new OFont("cour.ttf");
 	_title = new OText2D(_fontCourier, 12, -1.0f, 0.95f, OVector4(0.0f, 1.0f, 0.0f, 1.0f));
 	_title->setContent("Osiris Framework\nDemo Application");
-	_infoText = new OText2D(_fontCourier, 12, 0.45f, 0.95f, OVector4(0.0f, 1.0f, 0.0f, 1.0f));
+	_perfOverlay = new OPerfOverlay(this, _fontCourier, 12);
+	_perfOverlay->setTextPosition(0.35f, 0.95f);
+	_perfOverlay->setGraphArea(0.35f, -0.95f, 0.6f, 0.3f);
 	_motionText = new OText2D(_fontCourier, 12, -1.0f, 0.50f, OVector4(0.0f, 1.0f, 0.0f, 1.0f));
 	_cameraText = new OText2D(_fontCourier, 12, -1.0f, -0.90f, OVector4(0.0f, 1.0f, 0.0f, 1.0f));
 	renderObjects()->add(_title);
-	renderObjects()->add(_infoText);
+	renderObjects()->add(_perfOverlay);
 	renderObjects()->add(_motionText);
 	renderObjects()->add(_cameraText);
 }
@@ -139,19 +142,6 @@ void DemoSimulation::update(const OTimeIndex & idx, int step_us)
 	/* update camera */
 	_camCtrl.update(idx, step_us);
 
-	/* calculate FPS average and update the text object (to show on the screen) */
-	if (targetFPS() == 0) snprintf(buff, 32, "%.02f fps", fpsStats().average());
-	else snprintf(buff, 256, "%.02f/%d fps", fpsStats().average(), targetFPS());
-	
-	/* simulation stats and idle time */
-	snprintf(buff, 256,
-		 "%s\n"
-		 "Perf coef: %.04f\n"
-		 "Idle time: %.02f us\n"
-		 "Render time: %.02f us", 
-		 buff, performanceStats().average(), idleTimeStats().average(), renderTimeStats().average());
-	_infoText->setContent(buff);
-
 	/* motion info */
 	OVector3 movPos = _movingPiece->state()->curr()->position();
 	OVector3 movSpd = _movingPiece->state()->curr()->motionComponent(1) * 1e6;
@@ -177,6 +167,10 @@ void DemoSimulation::onKeyboardPress(const OKeyboardPressEvent * evt)
 		if (targetFPS() == 0) setTargetFPS(40);
 		else setTargetFPS(0);
 		break;
+
+	case OKeyboardPressEvent::OKey_g:
+		OGPUTimer::setEnabled(!OGPUTimer::enabled());
+		break;
 		
 	case OKeyboardPressEvent::OKey_o:
 		camera()->setPosition(OVector3(3.0f, 1.5f, 7.0f));
@@ -5,6 +5,7 @@
 #include <OsirisSDK/OCameraController.h>
 #include <OsirisSDK/OFont.h>
 #include <OsirisSDK/OText2D.h>
+#include <OsirisSDK/OPerfOverlay.h>
 
 class DemoSimulation : public OSimulation, public OObject
 {
@@ -22,7 +23,7 @@ private:
 	OCameraController _camCtrl;
 	OFont* _fontCourier;
 	OText2D* _title;
-	OText2D* _infoText;
+	OPerfOverlay* _perfOverlay;
 	OText2D* _motionText;
 	OText2D* _cameraText;
 	OEntity* _table;
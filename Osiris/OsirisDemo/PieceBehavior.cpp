@@ -15,15 +15,33 @@ PieceBehavior::~PieceBehavior()
 {
 }
 
+static OParameterSchema buildAttributeSchema()
+{
+	OParameterSchema schema("PieceBehavior");
+	schema.define(PieceBehavior::attrMinX, 0.0f);
+	schema.define(PieceBehavior::attrMaxX, 0.0f);
+	schema.define(PieceBehavior::attrMinZ, 0.0f);
+	schema.define(PieceBehavior::attrMaxZ, 0.0f);
+	return schema;
+}
+
+const OParameterSchema * PieceBehavior::attributeSchema()
+{
+	/* function-local static: built once, thread-safe */
+	static const OParameterSchema schema = buildAttributeSchema();
+	return &schema;
+}
+
 void PieceBehavior::update(OParameterList ** attribute, ODoubleBuffer<OState>* state, OMesh ** meshPtr, 
 			   const OTimeIndex & timeIndex, int step_us)
 {
-	if (state->curr()->position().x() <= (**attribute)[attrMinX].floatVal())
+	OParameterList *attr = *attribute;
+	if (state->curr()->position().x() <= attr->get(MinX()))
 		state->next()->motionComponent(1).setX(fabs(state->curr()->motionComponent(1).x()));
-	if (state->curr()->position().x() >= (**attribute)[attrMaxX].floatVal())
+	if (state->curr()->position().x() >= attr->get(MaxX()))
 		state->next()->motionComponent(1).setX(-fabs(state->curr()->motionComponent(1).x()));
-	if (state->curr()->position().z() <= (**attribute)[attrMinZ].floatVal())
+	if (state->curr()->position().z() <= attr->get(MinZ()))
 		state->next()->motionComponent(1).setZ(fabs(state->curr()->motionComponent(1).z()));
-	if (state->curr()->position().z() >= (**attribute)[attrMaxZ].floatVal())
+	if (state->curr()->position().z() >= attr->get(MaxZ()))
 		state->next()->motionComponent(1).setZ(-fabs(state->curr()->motionComponent(1).z()));
 }
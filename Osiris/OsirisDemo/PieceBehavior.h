@@ -1,6 +1,7 @@
 #pragma once
 
 #include <OsirisSDK/OBehavior.h>
+#include <OsirisSDK/OParameterList.h>
 
 class PieceBehavior : public OBehavior
 {
@@ -15,6 +16,16 @@ public:
 		attrMaxZ
 	};
 
+	typedef OParameterHandle<float, attrMinX> MinX;
+	typedef OParameterHandle<float, attrMaxX> MaxX;
+	typedef OParameterHandle<float, attrMinZ> MinZ;
+	typedef OParameterHandle<float, attrMaxZ> MaxZ;
+
+	/**
+	 @brief Attribute schema shared by all piece entities.
+	 */
+	static const OParameterSchema* attributeSchema();
+
 	virtual void update(OParameterList ** attribute, 
 			    ODoubleBuffer<OState>* state, 
 			    OMesh ** meshPtr, 
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <OsirisSDK/OMetricsLayout.h>
+
+/*
+ * Samples a metrics file written by OMetricsExporter and prints its records.
+ *
+ * Usage: OsirisMetricsReader <metrics file> [-i interval_ms] [-n count]
+ */
+
+static const OMetricsFile* mapFile(const char* filename)
+{
+#ifdef WIN32
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+				  FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return NULL;
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, sizeof(OMetricsFile), NULL);
+	if (mapping == NULL) return NULL;
+	return (const OMetricsFile*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(OMetricsFile));
+#else
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) return NULL;
+	void *addr = mmap(NULL, sizeof(OMetricsFile), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	return (addr != MAP_FAILED) ? (const OMetricsFile*)addr : NULL;
+#endif
+}
+
+static void printRecords(const OMetricsFile* file)
+{
+	printf("%-28s %8s %12s %12s %12s %12s %12s %12s\n", "metric", "n", "last", "avg", "stdev", "p50", "p99", "max");
+	unsigned int count = file->header.recordCount.load(std::memory_order_acquire);
+	if (count > file->header.recordCapacity) count = file->header.recordCapacity;
+	for (unsigned int i = 0; i < count; i++) {
+		const OMetricsRecord *record = &file->records[i];
+		OMetricsValues values;
+		if (!OMetricsReadRecord(record, &values)) {
+			printf("%-28.28s (busy)\n", record->name);
+			continue;
+		}
+		printf("%-28.28s %8d %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f\n", record->name, values.sampleCount,
+		       values.last, values.average, values.stdev, values.p50, values.p99, values.maxValue);
+	}
+	printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s <metrics file> [-i interval_ms] [-n count]\n", argv[0]);
+		return 1;
+	}
+
+	int interval_ms = 1000;
+	int samples = 0;
+	for (int i = 2; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "-i") == 0) interval_ms = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "-n") == 0) samples = atoi(argv[i + 1]);
+	}
+
+	const OMetricsFile *file = mapFile(argv[1]);
+	if (file == NULL) {
+		fprintf(stderr, "Error mapping metrics file: '%s'.\n", argv[1]);
+		return 1;
+	}
+	if (memcmp(file->header.magic, OMETRICS_MAGIC, sizeof(file->header.magic)) != 0 ||
+	    file->header.version != OMETRICS_VERSION || file->header.recordSize != sizeof(OMetricsRecord)) {
+		fprintf(stderr, "Invalid metrics file: '%s'.\n", argv[1]);
+		return 1;
+	}
+
+	/* sampling is done on the mapped memory only, without system calls */
+	unsigned int lastUpdate = 0;
+	for (int n = 0; samples == 0 || n < samples; n++) {
+		if (n > 0) std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+		unsigned int update = file->header.updateCount.load(std::memory_order_acquire);
+		printf("[pid %u, update %u%s]\n", file->header.processId, update, (n > 0 && update == lastUpdate) ? ", stale" : "");
+		printRecords(file);
+		lastUpdate = update;
+	}
+
+	return 0;
+}
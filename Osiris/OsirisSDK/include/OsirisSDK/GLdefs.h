@@ -4,4 +4,6 @@
 #include <glload/gl_load.hpp>
 #include <gl/freeglut.h>
 
+#include "OGLCounters.h"
+
 #define OSIRIS_GL_VERSION	3, 3
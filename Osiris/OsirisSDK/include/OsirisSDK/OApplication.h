@@ -1,14 +1,21 @@
 #pragma once
 
 #include <string>
-#include <list>
-#include <queue>
+#include <vector>
 
 #include "defs.h"
 #include "OCamera.h"
 #include "OMath.h"
 #include "OObject.h"
 #include "OEvent.h"
+#include "OEventQueue.h"
+#include "OFramePacer.h"
+#include "OThreadPool.h"
+#include "OTimerWheel.h"
+#include "OInputRecorder.h"
+#include "OInputReplay.h"
+#include "OMetricsExporter.h"
+#include "OProfiler.h"
 #include "OTimeIndex.h"
 #include "OStats.hpp"
 
@@ -36,6 +43,22 @@
 #define OAPPLICATION_DEFAULT_SIMULATIONSTEP	20000
 #endif
 
+#ifndef OAPPLICATION_DEFAULT_EVENTQUEUE_CAPACITY
+#define OAPPLICATION_DEFAULT_EVENTQUEUE_CAPACITY	1024
+#endif
+
+#ifndef OAPPLICATION_DEFAULT_TIMERRESOLUTION
+#define OAPPLICATION_DEFAULT_TIMERRESOLUTION	1000
+#endif
+
+#ifndef OAPPLICATION_PARALLELDISPATCH_MINRECIPIENTS
+#define OAPPLICATION_PARALLELDISPATCH_MINRECIPIENTS	256
+#endif
+
+#ifndef OAPPLICATION_PARALLELDISPATCH_CHUNKSIZE
+#define OAPPLICATION_PARALLELDISPATCH_CHUNKSIZE	64
+#endif
+
 /**
  \brief The Osiris Application base class. 
 
@@ -45,6 +68,18 @@
 class OAPI OApplication
 {
 public:
+	/**
+	 \brief Event coalescing policies.
+
+	 Coalescing is applied on each frame to consecutive queued events of the same type, before
+	 they are delivered to their recipients.
+	 */
+	enum EventCoalescing {
+		NoCoalescing,		/**< Every queued event is delivered. */
+		KeepLatest,		/**< Only the latest of consecutive events is delivered. */
+		AccumulateDeltas	/**< Only the latest of consecutive events is delivered, carrying the sum of
+					     their movement deltas. Same as KeepLatest for events without deltas. */
+	};
 
 	/**
 	 \brief Class constructor.
@@ -116,8 +151,100 @@ public:
 	 */
 	void setSimulationStep(int simulationStep);
 
+	/**
+	 \brief Enables or disables the fixed timestep mode.
+
+	 In fixed timestep mode the wall clock is ignored by the simulation: each loop iteration runs exactly one
+	 simulation step, so that runs are reproducible frame for frame. Disabled by default.
+	 */
+	void setFixedTimestep(bool enabled);
+
+	/**
+	 \brief Returns true if the fixed timestep mode is enabled.
+	 */
+	bool fixedTimestep() const;
+
+	/**
+	 \brief Starts recording input events to a log file.
+
+	 Every event taken from the event queue is written along with the simulation time at which it was
+	 delivered. The log can be played back with startInputReplay().
+
+	 \param filename Log file name.
+	 */
+	void startInputRecording(const char* filename);
+
+	/**
+	 \brief Stops recording input events and closes the log file.
+	 */
+	void stopInputRecording();
+
+	/**
+	 \brief Starts playing back an input log.
+
+	 Logged events are queued at the simulation time they were recorded, relative to the start of the
+	 replay. While replaying, keyboard and mouse input from the window is ignored.
+
+	 \param filename Log file name.
+	 */
+	void startInputReplay(const char* filename);
+
+	/**
+	 \brief Stops playing back the input log.
+	 */
+	void stopInputReplay();
+
+	/**
+	 \brief Returns true while an input log is being played back.
+	 */
+	bool isReplayingInput() const;
+
+	/**
+	 \brief Number of logged events dropped by the current or last input replay, because the event queue was full.
+
+	 If not zero, the replay did not reproduce the recording.
+	 */
+	int replayDroppedEventCount() const;
+
+	/**
+	 \brief Starts exporting the application metrics to a memory-mapped file.
+
+	 Registers the application statistics (see registerMetrics()) on a new OMetricsExporter, which is updated at
+	 the end of each loop iteration. Any previous export is stopped.
+
+	 \param filename Metrics file name.
+	 \param interval_us Minimum interval between exports, in microseconds.
+	 \return The exporter, which may be used to add metrics or open a file sink.
+	 */
+	OMetricsExporter* startMetricsExport(const char* filename, int interval_us=OMETRICSEXPORTER_DEFAULT_INTERVAL_US);
+
+	/**
+	 \brief Stops the metrics export.
+	 */
+	void stopMetricsExport();
+
+	/**
+	 \brief Returns the metrics exporter, or NULL if metrics are not being exported.
+	 */
+	OMetricsExporter* metricsExporter();
+
+	/**
+	 \brief Sets a key that exports the profiler trace when pressed.
+
+	 The trace is written with OProfiler::exportChromeTrace(). Only meaningful when the profiler
+	 instrumentation is compiled in (OSIRIS_PROFILER): otherwise the key is delivered as any other.
+
+	 \param key Key code.
+	 \param filename Trace file name.
+	 */
+	void setProfilerExportKey(OKeyboardPressEvent::KeyCode key, const char* filename);
+
 	/**
 	 \brief Adds an OObject class object as event recipient for given type.
+
+	 Recipients that are not thread-safe (see OObject::isEventThreadSafe()) receive events first, in the
+	 order they were added, followed by the thread-safe recipients.
+
 	 \param eventType Event type.
 	 \param recipient Object that will receive the events.
 	 */
@@ -130,6 +257,89 @@ public:
 	 */
 	void removeEventRecipient(OEvent::EventType eventType, OObject* recipient);
 
+	/**
+	 \brief Queue event to be processed by the application and the subscribed OOBject class objects.
+
+	 This method does not allocate memory nor take locks, and may be called from any thread.
+
+	 \param evt Event record.
+	 \return False if the event queue is full and the event was dropped.
+	 */
+	bool queueEvent(const OEventQueue::Record& evt);
+
+	/**
+	 \brief Number of events dropped because the event queue was full.
+	 */
+	unsigned int droppedEventCount() const;
+
+	/**
+	 \brief Sets the coalescing policy of an event type.
+
+	 By default, mouse movement events accumulate their deltas, resize events keep the latest and
+	 all other events are not coalesced.
+	 */
+	void setEventCoalescing(OEvent::EventType eventType, EventCoalescing policy);
+
+	/**
+	 \brief Returns the coalescing policy of an event type.
+	 */
+	EventCoalescing eventCoalescing(OEvent::EventType eventType) const;
+
+	/**
+	 \brief Number of events taken from the event queue on the last frame, before coalescing.
+	 */
+	int rawEventCount() const;
+
+	/**
+	 \brief Number of events delivered to recipients on the last frame, after coalescing.
+	 */
+	int deliveredEventCount() const;
+
+	/**
+	 \brief Enables or disables parallel event dispatch.
+
+	 When enabled, thread-safe event recipients are processed in parallel chunks by the application thread
+	 pool, if there are at least OAPPLICATION_PARALLELDISPATCH_MINRECIPIENTS of them for the event type.
+	 Other recipients are always processed serially, before the parallel ones. Disabled by default.
+	 */
+	void setParallelEventDispatch(bool enabled);
+
+	/**
+	 \brief Returns true if parallel event dispatch is enabled.
+	 */
+	bool parallelEventDispatch() const;
+
+	/**
+	 \brief Returns the application thread pool, creating it on first use.
+	 */
+	OThreadPool* threadPool();
+
+	/**
+	 \brief Returns the current simulation time index.
+	 */
+	const OTimeIndex& simulationTimeIndex() const;
+
+	/**
+	 \brief Schedules a timer callback.
+
+	 Timers are processed inside the simulation loop, before each simulation step, and fire through the
+	 target object's OObject::processTimer() method. Timers of objects deleted through scheduleDelete()
+	 are cancelled automatically.
+
+	 \param target Object that will receive the timer callback.
+	 \param timerId Timer identifier passed on to the target object.
+	 \param timeIndex Simulation time index at which the timer fires.
+	 \param period_us Timer period in microseconds for periodic timers, or zero for one-shot timers.
+	 \return Handle that can be used to cancel the timer.
+	 */
+	OTimerWheel::Handle scheduleTimer(OObject* target, int timerId, const OTimeIndex& timeIndex, int period_us=0);
+
+	/**
+	 \brief Cancels a timer.
+	 \return False if the timer had already fired or had been cancelled.
+	 */
+	bool cancelTimer(const OTimerWheel::Handle& handle);
+
 	/**
 	 \brief Initializes the application and starts the main loop.
 	*/
@@ -150,11 +360,23 @@ public:
 	 */
 	const OStats<int>& idleTimeStats() const;
 
+	/**
+	 \brief Frame pacer, which limits the frame rate to the target FPS and keeps frame time and jitter statistics.
+	 */
+	const OFramePacer& framePacer() const;
+
 	/**
 	 \brief Renderization time statistics in microseconds.
 	 */
 	const OStats<int>& renderTimeStats() const;
 
+	/**
+	 \brief Simulation time statistics, per frame, in microseconds.
+
+	 Time spent on all the simulation steps taken on each frame.
+	 */
+	const OStats<int>& simulationTimeStats() const;
+
 	/**
 	 \brief Performance coefficient statistics.
 
@@ -166,6 +388,22 @@ public:
 	 */
 	const OStats<float>& performanceStats() const;
 
+	/**
+	 \brief Input-to-dispatch latency statistics in microseconds.
+
+	 Time elapsed between the reception of an input (the GLUT callback) and the delivery of the
+	 corresponding event to its recipients.
+	 */
+	const OStats<int>& inputDispatchLatencyStats() const;
+
+	/**
+	 \brief Input-to-present latency statistics in microseconds.
+
+	 Time elapsed between the reception of an input and the buffer swap of the first frame rendered
+	 after the corresponding event was delivered.
+	 */
+	const OStats<int>& inputPresentLatencyStats() const;
+
 	/**
 	 \brief Returns active OApplication instance.
 	 */
@@ -187,11 +425,6 @@ protected:
 	 */
 	int eventRecipientCount(OEvent::EventType type);
 
-	/**
-	 \brief Queue event to be processed by the application and the subscribed OOBject class objects.
-	 */
-	void queueEvent(OEvent* evt);
-
 	/**
 	 \brief Process event queue.
 	 */
@@ -202,6 +435,14 @@ protected:
 	 */
 	void deleteObjects();
 
+	/**
+	 \brief Registers the metrics exported by startMetricsExport().
+
+	 The default implementation registers the frame, simulation, render and input latency statistics, event counts
+	 and the process memory. Derived classes may override it to add their own metrics.
+	 */
+	virtual void registerMetrics(OMetricsExporter* exporter);
+
 	/**
 	 \brief Method called on each simulation iteration.
 	 \brief timeIndex Time index.
@@ -218,15 +459,35 @@ private:
 	static OApplication* _activeInstance;
 	OCamera _cam;
 	std::map<OObject*, int> _deleteList;
-	std::map<OEvent::EventType, std::list<OObject*> > _eventRecipients;
-	std::queue<OEvent*> _eventQueue;
-	int _targetFPS;
+	std::vector<OObject*> _eventRecipients[OEvent::EventTypeCount];
+	std::vector<OObject*> _parallelEventRecipients[OEvent::EventTypeCount];
+	bool _parallelEventDispatch;
+	OThreadPool* _threadPool;
+	OEventQueue _eventQueue;
+	std::vector<OEventQueue::Record> _eventBatch;
+	EventCoalescing _eventCoalescing[OEvent::EventTypeCount];
+	int _rawEventCount;
+	int _deliveredEventCount;
+	int _lastMouseX;
+	int _lastMouseY;
+	OFramePacer _framePacer;
 	int _simulationStep_us;
 	OStats<float> _fpsStats;
 	OStats<int> _idleTimeStats;
 	OStats<int> _renderTimeStats;
+	OStats<int> _simulationTimeStats;
 	OStats<float> _simulationPerformanceStats;
+	OStats<int> _inputDispatchLatencyStats;
+	OStats<int> _inputPresentLatencyStats;
 	OTimeIndex _simulationTimeIndex;
+	OTimerWheel _timerWheel;
+	bool _fixedTimestep;
+	OInputRecorder* _inputRecorder;
+	OInputReplay* _inputReplay;
+	int _replayDroppedEventCount;
+	OMetricsExporter* _metricsExporter;
+	int _profilerExportKey;
+	std::string _profilerExportFile;
 	OTimeIndex _lastRenderTimeIndex;
 
 	/**
@@ -234,6 +495,16 @@ private:
 	 */
 	void loopIteration();
 
+	/**
+	 Creates the event object for a record and delivers it to its recipients.
+	 */
+	void dispatchEvent(const OEventQueue::Record& rec);
+
+	/**
+	 Delivers an event to its recipients.
+	 */
+	void dispatchEvent(OEvent* evt);
+
 	static void keyboardCallback(unsigned char key, int mouse_x, int mouse_y);
 	static void keyboardUpCallback(unsigned char key, int mouse_x, int mouse_y);
 	static void mouseCallback(int button, int state, int x, int y);
@@ -56,6 +56,20 @@ public:
 			    const OTimeIndex& timeIndex, 
 			    int step_us) = 0;
 
+	/**
+	 @brief Timer handler.
+
+	 This is meant to be called by OEntity class objects when a timer scheduled for the entity with
+	 OApplication::scheduleTimer() fires. Timers allow behaviors to stay dormant instead of polling on
+	 every update. By default does nothing.
+
+	 @param attribute Entity attributes.
+	 @param state Entity state.
+	 @param timerId Timer identifier.
+	 @param timeIndex Simulation time index.
+	 */
+	virtual void onTimer(OParameterList** attribute, ODoubleBuffer<OState>* state, int timerId, const OTimeIndex& timeIndex);
+
 protected:
 	/**
 	 @brief Keyboard press event handler.
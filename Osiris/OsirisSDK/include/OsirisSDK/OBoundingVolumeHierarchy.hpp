@@ -0,0 +1,234 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "defs.h"
+#include "OMath.h"
+#include "OFrustum.h"
+
+#ifndef OBVH_LEAFSIZE
+#define OBVH_LEAFSIZE	OFRUSTUM_BATCH
+#endif
+
+#ifndef OBVH_MAXDEPTH
+#define OBVH_MAXDEPTH	64
+#endif
+
+/**
+ @brief Bounding volume hierarchy, for frustum culling of objects that don't move.
+
+ Items are added along with their bounding spheres, and then the tree is built: nodes are axis-aligned boxes,
+ split at the median of the item centers, along their largest axis, until they hold up to OBVH_LEAFSIZE items.
+ The items of each subtree are kept contiguous, so that culling rejects whole subtrees that are outside of the
+ frustum and accepts whole subtrees that are inside of it, without testing their items. Only the items on leaves
+ that intersect the frustum are tested, as a batch (see OFrustum::intersects()).
+
+ The tree is not updated when the items move: it must be built again.
+ */
+template<class T> class OBoundingVolumeHierarchy
+{
+public:
+	/**
+	 @brief Class constructor.
+	 */
+	OBoundingVolumeHierarchy() { }
+
+	/**
+	 @brief Class destructor.
+	 */
+	virtual ~OBoundingVolumeHierarchy() { }
+
+	/**
+	 @brief Removes all items and nodes.
+	 */
+	void clear()
+	{
+		_items.clear();
+		_x.clear();
+		_y.clear();
+		_z.clear();
+		_radius.clear();
+		_nodes.clear();
+	}
+
+	/**
+	 @brief Adds an item. The tree must be built before culling.
+	 @param item Item.
+	 @param center Item bounding sphere center.
+	 @param radius Item bounding sphere radius.
+	 */
+	void add(T* item, const OVector3& center, float radius)
+	{
+		_items.push_back(item);
+		_x.push_back(center.x());
+		_y.push_back(center.y());
+		_z.push_back(center.z());
+		_radius.push_back(radius);
+	}
+
+	/**
+	 @brief Builds the tree over the items added so far.
+	 */
+	void build()
+	{
+		_nodes.clear();
+		if (_items.empty()) return;
+		_nodes.reserve(2 * (_items.size() / OBVH_LEAFSIZE + 1));
+		buildNode(0, (int)_items.size(), 0);
+	}
+
+	/**
+	 @brief Returns the number of items.
+	 */
+	int itemCount() const
+	{
+		return (int)_items.size();
+	}
+
+	/**
+	 @brief Returns the number of nodes.
+	 */
+	int nodeCount() const
+	{
+		return (int)_nodes.size();
+	}
+
+	/**
+	 @brief Finds the items that are at least partially inside of a frustum.
+	 @param frustum View frustum.
+	 @param visible Vector where the visible items are appended to.
+	 @return Number of visible items.
+	 */
+	int cull(const OFrustum& frustum, std::vector<T*>& visible) const
+	{
+		if (_nodes.empty()) return 0;
+
+		size_t start = visible.size();
+		struct Pending {
+			int node;
+			unsigned int planeMask;
+		} stack[OBVH_MAXDEPTH];
+		int top = 0;
+		stack[top].node = 0;
+		stack[top].planeMask = OFrustum::AllPlanes;
+		top++;
+
+		while (top > 0) {
+			top--;
+			int nodeIdx = stack[top].node;
+			const Node& node = _nodes[nodeIdx];
+			unsigned int planeMask = stack[top].planeMask;
+
+			/* planes that the parent is inside of are not tested again */
+			OFrustum::Intersection result = frustum.classify(node.min, node.max, planeMask);
+			if (result == OFrustum::Outside) continue;
+			if (result == OFrustum::Inside) {
+				visible.insert(visible.end(), _items.begin() + node.first, _items.begin() + node.first + node.count);
+				continue;
+			}
+
+			if (node.right < 0) {
+				unsigned char leafVisible[OBVH_LEAFSIZE];
+				frustum.intersects(&_x[node.first], &_y[node.first], &_z[node.first], &_radius[node.first],
+						   node.count, leafVisible);
+				for (int i = 0; i < node.count; i++) {
+					if (leafVisible[i]) visible.push_back(_items[node.first + i]);
+				}
+				continue;
+			}
+
+			stack[top].node = node.right;
+			stack[top].planeMask = planeMask;
+			top++;
+			stack[top].node = nodeIdx + 1;
+			stack[top].planeMask = planeMask;
+			top++;
+		}
+
+		return (int)(visible.size() - start);
+	}
+
+private:
+	struct Node {
+		float min[3];
+		float max[3];
+		int first;		/* first item */
+		int count;		/* number of items */
+		int right;		/* right child, or -1 on leaves: the left child comes right after its parent */
+	};
+
+	std::vector<T*> _items;
+	std::vector<float> _x;
+	std::vector<float> _y;
+	std::vector<float> _z;
+	std::vector<float> _radius;
+	std::vector<Node> _nodes;
+
+	int buildNode(int first, int count, int depth)
+	{
+		int idx = (int)_nodes.size();
+		_nodes.push_back(Node());
+
+		/* node box around the item spheres, and the box of the item centers, to choose the split axis */
+		float cmin[3], cmax[3];
+		Node node;
+		node.first = first;
+		node.count = count;
+		node.right = -1;
+		for (int a = 0; a < 3; a++) {
+			node.min[a] = cmin[a] = 3.4e38f;
+			node.max[a] = cmax[a] = -3.4e38f;
+		}
+		for (int i = first; i < first + count; i++) {
+			float c[3] = { _x[i], _y[i], _z[i] };
+			for (int a = 0; a < 3; a++) {
+				if (c[a] - _radius[i] < node.min[a]) node.min[a] = c[a] - _radius[i];
+				if (c[a] + _radius[i] > node.max[a]) node.max[a] = c[a] + _radius[i];
+				if (c[a] < cmin[a]) cmin[a] = c[a];
+				if (c[a] > cmax[a]) cmax[a] = c[a];
+			}
+		}
+
+		/* the depth is bounded, since the traversal stack holds up to one pending node per level */
+		if (count > OBVH_LEAFSIZE && depth < OBVH_MAXDEPTH - 2) {
+			int axis = 0;
+			for (int a = 1; a < 3; a++) {
+				if (cmax[a] - cmin[a] > cmax[axis] - cmin[axis]) axis = a;
+			}
+			int half = count / 2;
+			partition(first, count, half, axis);
+			buildNode(first, half, depth + 1);
+			node.right = buildNode(first + half, count - half, depth + 1);
+		}
+
+		_nodes[idx] = node;
+		return idx;
+	}
+
+	void partition(int first, int count, int nth, int axis)
+	{
+		/* items are sorted through an index, and then moved along with their spheres */
+		const std::vector<float>& key = (axis == 0) ? _x : ((axis == 1) ? _y : _z);
+		std::vector<int> order(count);
+		for (int i = 0; i < count; i++) order[i] = first + i;
+		std::nth_element(order.begin(), order.begin() + nth, order.end(),
+				 [&key](int a, int b) { return key[a] < key[b]; });
+
+		std::vector<T*> items(count);
+		std::vector<float> x(count), y(count), z(count), radius(count);
+		for (int i = 0; i < count; i++) {
+			items[i] = _items[order[i]];
+			x[i] = _x[order[i]];
+			y[i] = _y[order[i]];
+			z[i] = _z[order[i]];
+			radius[i] = _radius[order[i]];
+		}
+		std::copy(items.begin(), items.end(), _items.begin() + first);
+		std::copy(x.begin(), x.end(), _x.begin() + first);
+		std::copy(y.begin(), y.end(), _y.begin() + first);
+		std::copy(z.begin(), z.end(), _z.begin() + first);
+		std::copy(radius.begin(), radius.end(), _radius.begin() + first);
+	}
+};
+
@@ -4,9 +4,37 @@
 #include "OMatrixStack.h"
 #include "OMath.h"
 #include "OState.h"
+#include "OFrustum.h"
+
+#ifndef OCAMERA_UNIFORMBLOCK_BINDING
+#define OCAMERA_UNIFORMBLOCK_BINDING	0
+#endif
+
+#ifndef OCAMERA_UNIFORMBLOCK_NAME
+#define OCAMERA_UNIFORMBLOCK_NAME	"OCamera"
+#endif
 
 /**
  \brief Class that represents a camera on the scene.
+
+ The camera matrices are shared with the shaders through a uniform buffer, bound to the uniform block binding
+ point OCAMERA_UNIFORMBLOCK_BINDING. Shaders declare it as:
+
+ \code
+ layout (std140) uniform OCamera {
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+ };
+ \endcode
+
+ Shader programs bind the block named OCAMERA_UNIFORMBLOCK_NAME to that binding point when linked, so per-object
+ uploads only carry the model matrix, and the camera transformation is applied on the GPU.
+
+ Migration note: render objects used to be rendered with the stack returned by transform(), which already held the
+ camera transformation. Matrix stacks passed to ORenderObject::render() and OMesh::render() now carry model
+ transformations only, so code that starts them from transform() must start them from an empty stack instead, or
+ the camera is applied twice.
 */
 class OAPI OCamera
 {
@@ -108,10 +136,33 @@ public:
 	OState* state();
 
 	/**
-	 \brief Calculates the perspective and camera transformations.
-	 \return Matrix stack containing the transformation matrix.
+	 \brief Calculates the perspective and camera transformations, and updates the camera uniform buffer.
+
+	 Meant to be called once per frame, before rendering.
+	 \return Matrix stack containing the product of the projection and view matrices. It is not meant to be passed
+		 to render objects, as the shaders already apply the camera transformation.
 	 */
 	const OMatrixStack* transform();
+
+	/**
+	 \brief Returns the view (camera) matrix, as of the last call to transform().
+	 */
+	const OMatrix4x4& viewMatrix() const;
+
+	/**
+	 \brief Returns the perspective projection matrix, as of the last call to transform().
+	 */
+	const OMatrix4x4& projectionMatrix() const;
+
+	/**
+	 \brief Returns the product of the projection and view matrices, as of the last call to transform().
+	 */
+	const OMatrix4x4& viewProjectionMatrix() const;
+
+	/**
+	 \brief Returns the view frustum, as of the last call to transform().
+	 */
+	const OFrustum& frustum() const;
 	
 private:
 	/* control change to avoid unnecessary matrix recalculation */
@@ -128,5 +179,16 @@ private:
 
 	/* transform matrix: camera + perspective */
 	OMatrixStack _transform;
+
+	/* uniform buffer contents: view, projection and view-projection matrices */
+	OMatrix4x4 _matrices[3];
+	OFrustum _frustum;
+	GLuint _uniformBuffer;
+	bool _uniformBufferValid;
+
+	/**
+	 \brief Uploads the matrices to the camera uniform buffer, if they changed.
+	 */
+	void updateUniformBuffer(const OMatrix4x4& view, const OMatrix4x4& projection);
 };
 
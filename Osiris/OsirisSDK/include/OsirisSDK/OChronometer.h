@@ -5,6 +5,9 @@
 
 /**
  @brief Class designed to measure time intervals.
+
+ Readings are kept as raw OTimeIndex::ticks() values, which are cheap to take (rdtsc when the processor has an
+ invariant TSC), and only converted to time when requested.
  */
 class OAPI OChronometer
 {
@@ -47,7 +50,7 @@ public:
 	OTimeIndex lastPartialTime() const;
 
 private:
-	OTimeIndex _start;
-	OTimeIndex _last;
+	long long _start;
+	long long _last;
 };
 
@@ -10,7 +10,7 @@ public:
 	/**
 	 @brief Class constructor.
 	 */
-	OCollection() : _lastID(0) { }
+	OCollection() : _lastID(0), _revision(0) { }
 
 	/**
 	 @brief Class destructor.
@@ -45,6 +45,7 @@ public:
 		/* adding to internal maps */
 		_ptrMap[item] = newID;
 		_idMap[newID] = item;
+		_revision++;
 
 		return newID;
 	}
@@ -63,6 +64,7 @@ public:
 		/* adding to internal maps */
 		_ptrMap[item] = newID;
 		_idMap[newID] = item;
+		_revision++;
 		
 		return newID;
 	}
@@ -77,6 +79,7 @@ public:
 		if (it == _ptrMap.end()) return;
 		_idMap.erase(it->second);
 		_ptrMap.erase(item);
+		_revision++;
 	}
 
 	/**
@@ -89,6 +92,7 @@ public:
 		if (it == _idMap.end()) return;
 		_ptrMap.erase(it->second);
 		_idMap.erase(id);
+		_revision++;
 	}
 
 	/**
@@ -228,8 +232,14 @@ public:
 	 */
 	size_t count() { return _idMap.size(); }
 
+	/**
+	 @brief Returns a counter that changes whenever items are added or removed.
+	 */
+	unsigned long long revision() const { return _revision; }
+
 private:
 	ID _lastID;
+	unsigned long long _revision;
 	std::map<ID, T*> _idMap;
 	std::map<T*, ID> _ptrMap;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "OObject.h"
 #include "ORenderObject.h"
 #include "ODoubleBuffer.hpp"
@@ -42,6 +44,24 @@ public:
 	 */
 	void processEvent(const OEvent* evt);
 
+	/**
+	 @brief Entities are thread-safe event recipients.
+
+	 Events are handled by the behavior object, which is expected to only change the entity's own attributes and
+	 next state, so entities may receive events in parallel.
+	 */
+	bool isEventThreadSafe() const;
+
+	/**
+	 @brief Main timer handle.
+
+	 Timers are forwarded to the behavior object, in the same way as events.
+
+	 @param timerId Timer identifier.
+	 @param timeIndex Simulation time index.
+	 */
+	void processTimer(int timerId, const OTimeIndex& timeIndex);
+
 	void update(const OTimeIndex& timeIndex, int step_us);
 
 	void equalizeState();
@@ -50,6 +70,26 @@ public:
 
 	void render(OMatrixStack* stack);
 
+	/**
+	 @brief Applies the entity model transformation (position, orientation and scale) to the top of a matrix stack.
+	 */
+	void transform(OMatrixStack* stack);
+
+	/**
+	 @brief Submits the entity mesh to a render queue, with the entity model transformation.
+	 */
+	void submit(ORenderQueue* queue, OMatrixStack* stack);
+
+	/**
+	 @brief Returns true if the entity doesn't move on its own: it has no behavior, and no motion components.
+	 */
+	bool isStatic();
+
+	/**
+	 @brief Provides the mesh bounding sphere, with the entity model transformation.
+	 */
+	bool boundingSphere(OVector3& center, float& radius);
+
 	/**
 	 @brief Set object behavior.
 	 */
@@ -85,6 +125,18 @@ public:
 	 */
 	void setMesh(OMesh* mesh);
 
+	/**
+	 @brief Sets the occluder mesh: a low-poly proxy, lying inside of the entity mesh, that hides what is behind the
+		entity from the occlusion culling pass (see OOcclusionCuller). The proxy is never drawn, so it doesn't
+		need to be initialized.
+	 */
+	void setOccluder(OMesh* occluder);
+
+	/**
+	 @brief Returns pointer to the occluder mesh, or NULL if the entity is not an occluder.
+	 */
+	OMesh* occluder();
+
 	/**
 	 @brief Enables entity processing for each update call.
 	 */
@@ -100,11 +152,23 @@ public:
 	 */
 	bool isDisabled() const;
 
+	/**
+	 @brief Returns a counter that changes whenever an entity is shown or hidden, so that the simulation can tell
+		when its static entity hierarchy must be rebuilt. Other render objects (text, overlays) don't change it.
+	 */
+	static unsigned long long visibilityRevision();
+
+protected:
+	void onVisibilityChange();
 
 private:
 	OBehavior* _behavior;
 	OParameterList* _attributes;
 	ODoubleBuffer<OState> _state;
 	OMesh *_mesh;
+	OMesh *_occluder;
 	bool _disabled;
+
+	/* entities belong to the one simulation of the application, so a single counter serves it */
+	static std::atomic<unsigned long long> _visibilityRevision;
 };
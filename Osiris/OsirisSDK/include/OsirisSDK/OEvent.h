@@ -4,6 +4,7 @@
 #include "GLdefs.h" 
 
 #include "OMemoryPoolObject.hpp"
+#include "OTimeIndex.h"
 
 #ifndef OEVENT_MP_BLOCKSIZE
 #define OEVENT_MP_BLOCKSIZE	16
@@ -28,6 +29,16 @@ public:
 		ResizeEvent			/**< Screen resize event. Issues an OResizeEvent class object. */
 	};
 
+	/**
+	 \brief Number of event types, used to size per-type tables indexed by typeIndex().
+	 */
+	enum { EventTypeCount = ResizeEvent - KeyboardPressEvent + 1 };
+
+	/**
+	 \brief Returns the zero-based index of an event type.
+	 */
+	static int typeIndex(EventType type) { return type - KeyboardPressEvent; }
+
 	/**
 	 \brief Class constructor.
 	 \param type Event type.
@@ -44,8 +55,21 @@ public:
 	 */
 	EventType type() const;
 
+	/**
+	 \brief Returns the time index at which the input that originated the event was received.
+
+	 If several events were coalesced into this one, this is the time index of the oldest of them.
+	 */
+	const OTimeIndex& timestamp() const;
+
+	/**
+	 \brief Sets the event time stamp.
+	 */
+	void setTimestamp(const OTimeIndex& timestamp);
+
 private:
 	EventType _type;
+	OTimeIndex _timestamp;
 };
 
 /**
@@ -215,8 +239,10 @@ public:
 	 \param type Active or passive movement.
 	 \param x Window X-axis component in pixels.
 	 \param y Window Y-axis component in pixels.
+	 \param dx Movement on the X-axis since the previous mouse position, in pixels.
+	 \param dy Movement on the Y-axis since the previous mouse position, in pixels.
 	 */
-	OMouseMoveEvent(MovementType type, int x, int y);
+	OMouseMoveEvent(MovementType type, int x, int y, int dx=0, int dy=0);
 
 	/**
 	 \brief Class destructor.
@@ -232,10 +258,27 @@ public:
 	 \brief Window Y-axis component in pixels.
 	 */
 	int y() const;
+
+	/**
+	 \brief Movement on the X-axis since the previous mouse position, in pixels.
+
+	 If several movement events were coalesced into this one, this is the sum of their movements.
+	 */
+	int dx() const;
+
+	/**
+	 \brief Movement on the Y-axis since the previous mouse position, in pixels.
+
+	 If several movement events were coalesced into this one, this is the sum of their movements.
+	 */
+	int dy() const;
+
 private:
 	MovementType _type;
 	int _x;
 	int _y;
+	int _dx;
+	int _dy;
 };
 
 /**
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+
+#include "defs.h"
+#include "OEvent.h"
+
+/**
+ \brief Fixed-capacity, lock-free event queue.
+
+ Events are stored by value as Record objects, a tagged union of the payloads carried by the OEvent
+ classes, in a ring buffer allocated once at construction. Any number of threads may push events
+ concurrently, but only one thread (the application main loop) may pop them. Neither operation
+ allocates memory or takes locks.
+
+ If the queue is full, new events are dropped and accounted for in droppedCount().
+ */
+class OAPI OEventQueue
+{
+public:
+	/**
+	 \brief Value-type event record.
+
+	 The factory methods stamp the record with OTimeIndex::current().
+	 */
+	struct OAPI Record {
+		/**
+		 \brief Event type, which selects the active payload member.
+		 */
+		OEvent::EventType type;
+
+		/**
+		 \brief Time index, in microseconds, at which the input was received.
+		 */
+		long long timestamp_us;
+
+		/**
+		 \brief Event payload.
+		 */
+		union {
+			struct {
+				int code;	/**< Key code. */
+				int mouse_x;	/**< Mouse position on the X-axis. */
+				int mouse_y;	/**< Mouse position on the Y-axis. */
+			} keyboard;		/**< KeyboardPressEvent and KeyboardReleaseEvent payload. */
+			struct {
+				int button;	/**< Mouse button. */
+				int status;	/**< Mouse button status. */
+				int x;		/**< Window X-axis component in pixels. */
+				int y;		/**< Window Y-axis component in pixels. */
+			} mouseClick;		/**< MouseClickEvent payload. */
+			struct {
+				int x;		/**< Window X-axis component in pixels. */
+				int y;		/**< Window Y-axis component in pixels. */
+				int dx;		/**< Movement on the X-axis in pixels. */
+				int dy;		/**< Movement on the Y-axis in pixels. */
+			} mouseMove;		/**< MouseActiveMoveEvent and MousePassiveMoveEvent payload. */
+			struct {
+				int width;	/**< Window width in pixels. */
+				int height;	/**< Window height in pixels. */
+			} resize;		/**< ResizeEvent payload. */
+		} data;
+
+		/**
+		 \brief Creates a keyboard press or release event record.
+		 */
+		static Record keyboard(OKeyboardPressEvent::KeyCode code, int mouse_x, int mouse_y, bool key_pressed);
+
+		/**
+		 \brief Creates a mouse click event record.
+		 */
+		static Record mouseClick(OMouseClickEvent::MouseButton btn, OMouseClickEvent::MouseStatus status, int x, int y);
+
+		/**
+		 \brief Creates an active or passive mouse move event record.
+		 */
+		static Record mouseMove(OMouseMoveEvent::MovementType type, int x, int y, int dx=0, int dy=0);
+
+		/**
+		 \brief Creates a window resize event record.
+		 */
+		static Record resize(int width, int height);
+	};
+
+	/**
+	 \brief Class constructor.
+	 \param capacity Maximum number of queued events. Rounded up to the next power of two.
+	 */
+	OEventQueue(int capacity);
+
+	/**
+	 \brief Class destructor.
+	 */
+	virtual ~OEventQueue();
+
+	/**
+	 \brief Returns the queue capacity.
+	 */
+	int capacity() const;
+
+	/**
+	 \brief Pushes an event record into the queue. Safe to call from any thread.
+	 \return False if the queue is full and the event was dropped.
+	 */
+	bool push(const Record& rec);
+
+	/**
+	 \brief Pops the oldest event record from the queue. Must only be called from the consumer thread.
+	 \param rec Pointer to where the record will be copied.
+	 \return False if the queue is empty.
+	 */
+	bool pop(Record* rec);
+
+	/**
+	 \brief Number of events dropped because the queue was full.
+	 */
+	unsigned int droppedCount() const;
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		Record record;
+	};
+
+	Cell* _cells;
+	size_t _mask;
+	std::atomic<size_t> _enqueuePos;
+	size_t _dequeuePos;
+	std::atomic<unsigned int> _dropped;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "defs.h"
+#include "OStats.hpp"
+
+#ifndef OFRAMEPACER_DEFAULT_SPINMARGIN_US
+#define OFRAMEPACER_DEFAULT_SPINMARGIN_US	500
+#endif
+
+#ifndef OFRAMEPACER_OVERSHOOT_WEIGHT
+#define OFRAMEPACER_OVERSHOOT_WEIGHT		0.125
+#endif
+
+/**
+ \brief Frame rate limiter.
+
+ Frames are paced against absolute deadlines spaced by the target frame interval, so small delays on one frame
+ are absorbed by the following ones instead of building up drift. If the loop falls more than a whole interval
+ behind, the deadlines are restarted from the current time rather than rushing frames to catch up.
+
+ Since a thread sleep may wake up late by as much as a scheduler quantum, the pacer sleeps only until a margin
+ before the deadline and yields the processor in a loop for the rest of the interval. The margin is the spin
+ margin plus a running estimate (exponential moving average) of how late the sleeps wake up.
+ */
+class OAPI OFramePacer
+{
+public:
+	/**
+	 \brief Class constructor.
+	 \param targetFPS Target frame rate. If zero, wait() does not block.
+	 \param statsSampleSize Number of frames considered on the frame time and jitter statistics.
+	 */
+	OFramePacer(int targetFPS=0, int statsSampleSize=OSTATS_DEFAULT_SAMPLE_SIZE);
+
+	/**
+	 \brief Class destructor.
+	 */
+	virtual ~OFramePacer();
+
+	/**
+	 \brief Sets the target frame rate. If zero, frames are not limited.
+	 */
+	void setTargetFPS(int targetFPS);
+
+	/**
+	 \brief Returns the target frame rate.
+	 */
+	int targetFPS() const;
+
+	/**
+	 \brief Sets the time, in microseconds, spent yielding before a deadline on top of the overshoot estimate.
+	 */
+	void setSpinMargin(int spinMargin_us);
+
+	/**
+	 \brief Returns the spin margin in microseconds.
+	 */
+	int spinMargin() const;
+
+	/**
+	 \brief Blocks until the next frame deadline.
+	 \return Time spent waiting in microseconds. Zero if the deadline had already passed.
+	 */
+	int wait();
+
+	/**
+	 \brief Restarts the deadlines from the next wait() call and clears the statistics.
+	 */
+	void reset();
+
+	/**
+	 \brief Current estimate of the sleep wake-up delay, in microseconds.
+	 */
+	float overshootEstimate() const;
+
+	/**
+	 \brief Frame time (interval between consecutive wait() returns) statistics in microseconds.
+	 */
+	const OStats<int>& frameTimeStats() const;
+
+	/**
+	 \brief Frame time jitter statistics in microseconds.
+
+	 When a target frame rate is set, the jitter is the absolute deviation of each frame time from the target
+	 interval; otherwise, it is the absolute difference between consecutive frame times.
+	 */
+	const OStats<int>& jitterStats() const;
+
+private:
+	int _targetFPS;
+	long long _spinMargin_ns;
+	long long _deadline_ns;
+	long long _lastFrame_ns;
+	int _lastFrameTime_us;
+	double _overshoot_ns;
+	OStats<int> _frameTimeStats;
+	OStats<int> _jitterStats;
+
+	static long long now();
+};
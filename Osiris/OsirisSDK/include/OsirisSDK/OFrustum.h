@@ -0,0 +1,106 @@
+#pragma once
+
+#include "defs.h"
+#include "OMath.h"
+
+#ifndef OFRUSTUM_BATCH
+#define OFRUSTUM_BATCH	8
+#endif
+
+/**
+ \brief View frustum, used to cull objects that are not on the screen.
+
+ The six frustum planes (left, right, bottom, top, near and far) are extracted from a view-projection matrix, and
+ objects are tested by their bounding spheres. Spheres can be tested one at a time or in arrays: arrays are
+ processed in batches of OFRUSTUM_BATCH spheres, with SSE instructions where available. Axis-aligned boxes can be
+ classified as well, for hierarchical culling (see OBoundingVolumeHierarchy).
+ */
+class OAPI OFrustum
+{
+public:
+	/**
+	 \brief Frustum planes.
+	 */
+	enum Plane {
+		Plane_Left=0,
+		Plane_Right,
+		Plane_Bottom,
+		Plane_Top,
+		Plane_Near,
+		Plane_Far,
+		PlaneCount
+	};
+
+	/**
+	 \brief Plane mask with all of the frustum planes.
+	 */
+	static const unsigned int AllPlanes = (1 << PlaneCount) - 1;
+
+	/**
+	 \brief Result of a box classification.
+	 */
+	enum Intersection {
+		Outside=0,		/**< Completely outside of the frustum. */
+		Intersecting,		/**< Partially inside of the frustum. */
+		Inside			/**< Completely inside of the frustum. */
+	};
+
+	/**
+	 \brief Class constructor. The frustum contains everything until a matrix is set.
+	 */
+	OFrustum();
+
+	/**
+	 \brief Class destructor.
+	 */
+	virtual ~OFrustum();
+
+	/**
+	 \brief Extracts the frustum planes from a view-projection matrix.
+	 */
+	void setMatrix(const OMatrix4x4& viewProjection);
+
+	/**
+	 \brief Returns a frustum plane, in the form (a, b, c, d), where ax + by + cz + d is the distance of a point to
+		the plane, positive on the inner side.
+	 */
+	OVector4 plane(Plane p) const;
+
+	/**
+	 \brief Returns true if a sphere is at least partially inside the frustum.
+	 \param center Sphere center.
+	 \param radius Sphere radius.
+	 */
+	bool intersects(const OVector3& center, float radius) const;
+
+	/**
+	 \brief Tests an array of spheres.
+	 \param x Sphere center coordinates on the X axis.
+	 \param y Sphere center coordinates on the Y axis.
+	 \param z Sphere center coordinates on the Z axis.
+	 \param radius Sphere radii.
+	 \param count Number of spheres.
+	 \param visible Output array: set to 1 for spheres at least partially inside the frustum, 0 otherwise.
+	 \return Number of spheres inside the frustum.
+	 */
+	int intersects(const float* x, const float* y, const float* z, const float* radius, int count,
+		       unsigned char* visible) const;
+
+	/**
+	 \brief Classifies an axis-aligned box.
+	 \param min Box minimum coordinates (x, y and z).
+	 \param max Box maximum coordinates (x, y and z).
+	 \param planeMask Planes that are tested (bit n for plane n). Planes that the box is completely inside of are
+			  cleared, so that the mask can be passed on to the boxes contained in this one.
+	 \return Box classification.
+	 */
+	Intersection classify(const float* min, const float* max, unsigned int& planeMask) const;
+
+private:
+	/* planes in structure-of-arrays layout: a, b, c and d components of all planes */
+	float _a[PlaneCount];
+	float _b[PlaneCount];
+	float _c[PlaneCount];
+	float _d[PlaneCount];
+};
+
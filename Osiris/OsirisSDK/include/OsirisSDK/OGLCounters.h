@@ -0,0 +1,303 @@
+#pragma once
+
+#include <glload/gl_3_3.h>
+
+#include "defs.h"
+
+/**
+ \brief Per-frame counters of GL calls, by category.
+
+ When the SDK is built with the OSIRIS_GL_COUNTERS option, the GL entry points that issue draws, bind objects,
+ upload uniforms or change pipeline state are replaced, on every source that includes GLdefs.h, by thin
+ wrappers that increment the counter of their category before calling the actual entry point. Without the
+ option, the wrappers are not compiled and all counters read zero.
+
+ Counters are reset at the end of each frame by OApplication, after the buffer swap; frameCount() returns the
+ count of the last completed frame. Only the thread that holds the GL context may issue GL calls, so counters
+ are not synchronized.
+ */
+class OAPI OGLCounters
+{
+public:
+	/**
+	 \brief GL call categories.
+	 */
+	enum Category {
+		DrawCalls=0,		/**< Draw calls (glDraw*, glMultiDraw*). */
+		ProgramBinds,		/**< Shader program binds (glUseProgram). */
+		VertexArrayBinds,	/**< Vertex array object binds (glBindVertexArray). */
+		BufferBinds,		/**< Buffer object binds (glBindBuffer*). */
+		BufferUploads,		/**< Buffer data uploads (glBufferData, glBufferSubData). */
+		TextureBinds,		/**< Texture binds (glBindTexture). */
+		UniformUploads,		/**< Uniform uploads (glUniform*). */
+		LocationQueries,	/**< Uniform and attribute location queries (glGet*Location). */
+		StateChanges,		/**< Fixed-function state changes (glEnable, glDisable, glCullFace, etc). */
+		CategoryCount
+	};
+
+	/**
+	 \brief Returns true if the SDK was built with the counting layer (OSIRIS_GL_COUNTERS option).
+	 */
+	static bool enabled();
+
+	/**
+	 \brief Increments the counter of a category on the current frame.
+	 */
+	static void add(Category category);
+
+	/**
+	 \brief Closes the current frame: its counts become available through frameCount(), and the counters are reset.
+	 */
+	static void newFrame();
+
+	/**
+	 \brief Number of calls of a category on the last completed frame.
+	 */
+	static int frameCount(Category category);
+
+	/**
+	 \brief Number of calls of a category on the current (incomplete) frame.
+	 */
+	static int currentCount(Category category);
+
+	/**
+	 \brief Category name.
+	 */
+	static const char* categoryName(Category category);
+
+private:
+	static int _current[CategoryCount];
+	static int _lastFrame[CategoryCount];
+};
+
+inline void OGLCounters::add(Category category)
+{
+	_current[category]++;
+}
+
+#ifdef OSIRIS_GL_COUNTERS
+
+/*
+ * Counting wrappers. Each wrapper is defined before its entry point name is redefined, so that its body calls
+ * the actual entry point (glload may itself define the names as macros).
+ */
+inline void OGLCounted_glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	OGLCounters::add(OGLCounters::DrawCalls);
+	glDrawArrays(mode, first, count);
+}
+
+inline void OGLCounted_glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+	OGLCounters::add(OGLCounters::DrawCalls);
+	glDrawElements(mode, count, type, indices);
+}
+
+inline void OGLCounted_glMultiDrawArrays(GLenum mode, const GLint* first, const GLsizei* count, GLsizei drawcount)
+{
+	OGLCounters::add(OGLCounters::DrawCalls);
+	glMultiDrawArrays(mode, first, count, drawcount);
+}
+
+inline void OGLCounted_glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+{
+	OGLCounters::add(OGLCounters::DrawCalls);
+	glDrawArraysInstanced(mode, first, count, instances);
+}
+
+inline void OGLCounted_glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices,
+					       GLsizei instances)
+{
+	OGLCounters::add(OGLCounters::DrawCalls);
+	glDrawElementsInstanced(mode, count, type, indices, instances);
+}
+
+inline void OGLCounted_glUseProgram(GLuint program)
+{
+	OGLCounters::add(OGLCounters::ProgramBinds);
+	glUseProgram(program);
+}
+
+inline void OGLCounted_glBindVertexArray(GLuint array)
+{
+	OGLCounters::add(OGLCounters::VertexArrayBinds);
+	glBindVertexArray(array);
+}
+
+inline void OGLCounted_glBindBuffer(GLenum target, GLuint buffer)
+{
+	OGLCounters::add(OGLCounters::BufferBinds);
+	glBindBuffer(target, buffer);
+}
+
+inline void OGLCounted_glBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	OGLCounters::add(OGLCounters::BufferBinds);
+	glBindBufferBase(target, index, buffer);
+}
+
+inline void OGLCounted_glBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	OGLCounters::add(OGLCounters::BufferBinds);
+	glBindBufferRange(target, index, buffer, offset, size);
+}
+
+inline void OGLCounted_glBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+	OGLCounters::add(OGLCounters::BufferUploads);
+	glBufferData(target, size, data, usage);
+}
+
+inline void OGLCounted_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+	OGLCounters::add(OGLCounters::BufferUploads);
+	glBufferSubData(target, offset, size, data);
+}
+
+inline void OGLCounted_glBindTexture(GLenum target, GLuint texture)
+{
+	OGLCounters::add(OGLCounters::TextureBinds);
+	glBindTexture(target, texture);
+}
+
+inline void OGLCounted_glUniform1i(GLint location, GLint v0)
+{
+	OGLCounters::add(OGLCounters::UniformUploads);
+	glUniform1i(location, v0);
+}
+
+inline void OGLCounted_glUniform1f(GLint location, GLfloat v0)
+{
+	OGLCounters::add(OGLCounters::UniformUploads);
+	glUniform1f(location, v0);
+}
+
+inline void OGLCounted_glUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	OGLCounters::add(OGLCounters::UniformUploads);
+	glUniform3fv(location, count, value);
+}
+
+inline void OGLCounted_glUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+{
+	OGLCounters::add(OGLCounters::UniformUploads);
+	glUniform4fv(location, count, value);
+}
+
+inline void OGLCounted_glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+	OGLCounters::add(OGLCounters::UniformUploads);
+	glUniformMatrix4fv(location, count, transpose, value);
+}
+
+inline GLint OGLCounted_glGetUniformLocation(GLuint program, const GLchar* name)
+{
+	OGLCounters::add(OGLCounters::LocationQueries);
+	return glGetUniformLocation(program, name);
+}
+
+inline GLint OGLCounted_glGetAttribLocation(GLuint program, const GLchar* name)
+{
+	OGLCounters::add(OGLCounters::LocationQueries);
+	return glGetAttribLocation(program, name);
+}
+
+inline void OGLCounted_glEnable(GLenum cap)
+{
+	OGLCounters::add(OGLCounters::StateChanges);
+	glEnable(cap);
+}
+
+inline void OGLCounted_glDisable(GLenum cap)
+{
+	OGLCounters::add(OGLCounters::StateChanges);
+	glDisable(cap);
+}
+
+inline void OGLCounted_glCullFace(GLenum mode)
+{
+	OGLCounters::add(OGLCounters::StateChanges);
+	glCullFace(mode);
+}
+
+inline void OGLCounted_glFrontFace(GLenum mode)
+{
+	OGLCounters::add(OGLCounters::StateChanges);
+	glFrontFace(mode);
+}
+
+inline void OGLCounted_glDepthMask(GLboolean flag)
+{
+	OGLCounters::add(OGLCounters::StateChanges);
+	glDepthMask(flag);
+}
+
+inline void OGLCounted_glDepthFunc(GLenum func)
+{
+	OGLCounters::add(OGLCounters::StateChanges);
+	glDepthFunc(func);
+}
+
+inline void OGLCounted_glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	OGLCounters::add(OGLCounters::StateChanges);
+	glBlendFunc(sfactor, dfactor);
+}
+
+#undef glDrawArrays
+#undef glDrawElements
+#undef glMultiDrawArrays
+#undef glDrawArraysInstanced
+#undef glDrawElementsInstanced
+#undef glUseProgram
+#undef glBindVertexArray
+#undef glBindBuffer
+#undef glBindBufferBase
+#undef glBindBufferRange
+#undef glBufferData
+#undef glBufferSubData
+#undef glBindTexture
+#undef glUniform1i
+#undef glUniform1f
+#undef glUniform3fv
+#undef glUniform4fv
+#undef glUniformMatrix4fv
+#undef glGetUniformLocation
+#undef glGetAttribLocation
+#undef glEnable
+#undef glDisable
+#undef glCullFace
+#undef glFrontFace
+#undef glDepthMask
+#undef glDepthFunc
+#undef glBlendFunc
+
+#define glDrawArrays			OGLCounted_glDrawArrays
+#define glDrawElements			OGLCounted_glDrawElements
+#define glMultiDrawArrays		OGLCounted_glMultiDrawArrays
+#define glDrawArraysInstanced		OGLCounted_glDrawArraysInstanced
+#define glDrawElementsInstanced		OGLCounted_glDrawElementsInstanced
+#define glUseProgram			OGLCounted_glUseProgram
+#define glBindVertexArray		OGLCounted_glBindVertexArray
+#define glBindBuffer			OGLCounted_glBindBuffer
+#define glBindBufferBase		OGLCounted_glBindBufferBase
+#define glBindBufferRange		OGLCounted_glBindBufferRange
+#define glBufferData			OGLCounted_glBufferData
+#define glBufferSubData			OGLCounted_glBufferSubData
+#define glBindTexture			OGLCounted_glBindTexture
+#define glUniform1i			OGLCounted_glUniform1i
+#define glUniform1f			OGLCounted_glUniform1f
+#define glUniform3fv			OGLCounted_glUniform3fv
+#define glUniform4fv			OGLCounted_glUniform4fv
+#define glUniformMatrix4fv		OGLCounted_glUniformMatrix4fv
+#define glGetUniformLocation		OGLCounted_glGetUniformLocation
+#define glGetAttribLocation		OGLCounted_glGetAttribLocation
+#define glEnable			OGLCounted_glEnable
+#define glDisable			OGLCounted_glDisable
+#define glCullFace			OGLCounted_glCullFace
+#define glFrontFace			OGLCounted_glFrontFace
+#define glDepthMask			OGLCounted_glDepthMask
+#define glDepthFunc			OGLCounted_glDepthFunc
+#define glBlendFunc			OGLCounted_glBlendFunc
+
+#endif
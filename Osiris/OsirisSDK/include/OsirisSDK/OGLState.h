@@ -0,0 +1,326 @@
+#pragma once
+
+#include "GLdefs.h"
+#include "defs.h"
+
+#ifndef OGLSTATE_TEXTUREUNITS
+#define OGLSTATE_TEXTUREUNITS	16
+#endif
+
+#ifndef OGLSTATE_UNIFORMBINDINGS
+#define OGLSTATE_UNIFORMBINDINGS	16
+#endif
+
+/**
+ \brief Shadow copy of the GL state, used to skip redundant state changes.
+
+ SDK render paths change GL state through this class, which keeps track of the current shader program, vertex
+ array object, buffer bindings (including the first OGLSTATE_UNIFORMBINDINGS uniform buffer binding points),
+ texture bindings (GL_TEXTURE_2D on each of the first OGLSTATE_TEXTUREUNITS units), enabled capabilities
+ (blending, face culling, depth test and depth clamping), blending function, face culling mode and depth state.
+ Calls that would set a value that is already current are not issued to the driver.
+
+ Values start unknown, so the first call always goes through. Since the element array buffer binding belongs to
+ the vertex array object, it becomes unknown whenever the vertex array object changes. Objects must be deleted
+ through this class as well, so that the shadow bindings follow the GL rule that deleting a bound object unbinds
+ it. Code that changes GL state directly must call invalidate() afterwards.
+
+ The number of calls issued and skipped is counted per frame, as a measure of the driver calls saved. Like the
+ GL context, the class is not meant to be used from more than one thread.
+ */
+class OAPI OGLState
+{
+public:
+	/**
+	 \brief Binds a shader program (glUseProgram).
+	 */
+	static void useProgram(GLuint program);
+
+	/**
+	 \brief Binds a vertex array object (glBindVertexArray).
+	 */
+	static void bindVertexArray(GLuint vertexArray);
+
+	/**
+	 \brief Binds a buffer object (glBindBuffer).
+	 */
+	static void bindBuffer(GLenum target, GLuint buffer);
+
+	/**
+	 \brief Binds a buffer object to an indexed binding point (glBindBufferBase).
+
+	 Like glBindBufferBase, it binds the buffer to the generic target as well.
+	 */
+	static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+	/**
+	 \brief Selects the active texture unit (glActiveTexture).
+	 */
+	static void activeTexture(GLenum unit);
+
+	/**
+	 \brief Binds a texture on the active texture unit (glBindTexture).
+	 */
+	static void bindTexture(GLenum target, GLuint texture);
+
+	/**
+	 \brief Enables a capability (glEnable).
+	 */
+	static void enable(GLenum capability);
+
+	/**
+	 \brief Disables a capability (glDisable).
+	 */
+	static void disable(GLenum capability);
+
+	/**
+	 \brief Returns true if a capability is enabled. The driver is only queried if the value is unknown.
+	 */
+	static bool isEnabled(GLenum capability);
+
+	/**
+	 \brief Sets the blending function (glBlendFunc).
+	 */
+	static void blendFunc(GLenum sfactor, GLenum dfactor);
+
+	/**
+	 \brief Sets which faces are culled (glCullFace).
+	 */
+	static void cullFace(GLenum mode);
+
+	/**
+	 \brief Sets the front face vertex order (glFrontFace).
+	 */
+	static void frontFace(GLenum mode);
+
+	/**
+	 \brief Enables or disables depth buffer writes (glDepthMask).
+	 */
+	static void depthMask(GLboolean flag);
+
+	/**
+	 \brief Sets the depth test function (glDepthFunc).
+	 */
+	static void depthFunc(GLenum func);
+
+	/**
+	 \brief Deletes buffer objects (glDeleteBuffers), unbinding them.
+	 */
+	static void deleteBuffers(GLsizei n, const GLuint* buffers);
+
+	/**
+	 \brief Deletes vertex array objects (glDeleteVertexArrays), unbinding them.
+	 */
+	static void deleteVertexArrays(GLsizei n, const GLuint* vertexArrays);
+
+	/**
+	 \brief Deletes textures (glDeleteTextures), unbinding them.
+	 */
+	static void deleteTextures(GLsizei n, const GLuint* textures);
+
+	/**
+	 \brief Deletes a shader program (glDeleteProgram).
+	 */
+	static void deleteProgram(GLuint program);
+
+	/**
+	 \brief Forgets the whole shadow state, so the next calls are all issued.
+	 */
+	static void invalidate();
+
+	/**
+	 \brief Closes the current frame: its counts become available through frameIssued() and frameSkipped().
+	 */
+	static void newFrame();
+
+	/**
+	 \brief Number of state calls issued to the driver on the last completed frame.
+	 */
+	static int frameIssued();
+
+	/**
+	 \brief Number of redundant state calls skipped on the last completed frame.
+	 */
+	static int frameSkipped();
+
+private:
+	enum BufferTarget {
+		ArrayBuffer=0,
+		ElementArrayBuffer,
+		UniformBuffer,
+		BufferTargetCount
+	};
+
+	enum Capability {
+		Blend=0,
+		CullFace,
+		DepthTest,
+		DepthClamp,
+		CapabilityCount
+	};
+
+	static const GLuint Unknown = 0xffffffff;
+
+	static GLuint _program;
+	static GLuint _vertexArray;
+	static GLuint _buffers[BufferTargetCount];
+	static GLuint _uniformBindings[OGLSTATE_UNIFORMBINDINGS];
+	static GLuint _activeTexture;
+	static GLuint _textures[OGLSTATE_TEXTUREUNITS];
+	static GLuint _capabilities[CapabilityCount];
+	static GLuint _blendSrc;
+	static GLuint _blendDst;
+	static GLuint _cullFace;
+	static GLuint _frontFace;
+	static GLuint _depthMask;
+	static GLuint _depthFunc;
+
+	static int _issued;
+	static int _skipped;
+	static int _frameIssued;
+	static int _frameSkipped;
+
+	static bool changed(GLuint& shadow, GLuint value);
+	static int bufferIndex(GLenum target);
+	static int capabilityIndex(GLenum capability);
+};
+
+inline bool OGLState::changed(GLuint & shadow, GLuint value)
+{
+	if (shadow == value) {
+		_skipped++;
+		return false;
+	}
+	shadow = value;
+	_issued++;
+	return true;
+}
+
+inline int OGLState::bufferIndex(GLenum target)
+{
+	switch (target) {
+	case GL_ARRAY_BUFFER:		return ArrayBuffer;
+	case GL_ELEMENT_ARRAY_BUFFER:	return ElementArrayBuffer;
+	case GL_UNIFORM_BUFFER:		return UniformBuffer;
+	default:			return -1;
+	}
+}
+
+inline int OGLState::capabilityIndex(GLenum capability)
+{
+	switch (capability) {
+	case GL_BLEND:		return Blend;
+	case GL_CULL_FACE:	return CullFace;
+	case GL_DEPTH_TEST:	return DepthTest;
+	case GL_DEPTH_CLAMP:	return DepthClamp;
+	default:		return -1;
+	}
+}
+
+inline void OGLState::useProgram(GLuint program)
+{
+	if (changed(_program, program)) glUseProgram(program);
+}
+
+inline void OGLState::bindVertexArray(GLuint vertexArray)
+{
+	if (changed(_vertexArray, vertexArray)) {
+		glBindVertexArray(vertexArray);
+		_buffers[ElementArrayBuffer] = Unknown;
+	}
+}
+
+inline void OGLState::bindBuffer(GLenum target, GLuint buffer)
+{
+	int idx = bufferIndex(target);
+	if (idx < 0) {
+		_issued++;
+		glBindBuffer(target, buffer);
+	} else if (changed(_buffers[idx], buffer)) {
+		glBindBuffer(target, buffer);
+	}
+}
+
+inline void OGLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	if (target != GL_UNIFORM_BUFFER || index >= OGLSTATE_UNIFORMBINDINGS) {
+		_issued++;
+		glBindBufferBase(target, index, buffer);
+		int idx = bufferIndex(target);
+		if (idx >= 0) _buffers[idx] = buffer;
+	} else if (changed(_uniformBindings[index], buffer)) {
+		glBindBufferBase(target, index, buffer);
+		_buffers[UniformBuffer] = buffer;
+	}
+}
+
+inline void OGLState::activeTexture(GLenum unit)
+{
+	if (changed(_activeTexture, unit)) glActiveTexture(unit);
+}
+
+inline void OGLState::bindTexture(GLenum target, GLuint texture)
+{
+	GLuint unit = _activeTexture - GL_TEXTURE0;
+	if (target != GL_TEXTURE_2D || unit >= OGLSTATE_TEXTUREUNITS) {
+		/* untracked target, or unknown texture unit */
+		_issued++;
+		glBindTexture(target, texture);
+	} else if (changed(_textures[unit], texture)) {
+		glBindTexture(target, texture);
+	}
+}
+
+inline void OGLState::enable(GLenum capability)
+{
+	int idx = capabilityIndex(capability);
+	if (idx < 0) {
+		_issued++;
+		glEnable(capability);
+	} else if (changed(_capabilities[idx], GL_TRUE)) {
+		glEnable(capability);
+	}
+}
+
+inline void OGLState::disable(GLenum capability)
+{
+	int idx = capabilityIndex(capability);
+	if (idx < 0) {
+		_issued++;
+		glDisable(capability);
+	} else if (changed(_capabilities[idx], GL_FALSE)) {
+		glDisable(capability);
+	}
+}
+
+inline void OGLState::blendFunc(GLenum sfactor, GLenum dfactor)
+{
+	if (_blendSrc == sfactor && _blendDst == dfactor) {
+		_skipped++;
+		return;
+	}
+	_blendSrc = sfactor;
+	_blendDst = dfactor;
+	_issued++;
+	glBlendFunc(sfactor, dfactor);
+}
+
+inline void OGLState::cullFace(GLenum mode)
+{
+	if (changed(_cullFace, mode)) glCullFace(mode);
+}
+
+inline void OGLState::frontFace(GLenum mode)
+{
+	if (changed(_frontFace, mode)) glFrontFace(mode);
+}
+
+inline void OGLState::depthMask(GLboolean flag)
+{
+	if (changed(_depthMask, (flag) ? GL_TRUE : GL_FALSE)) glDepthMask(flag);
+}
+
+inline void OGLState::depthFunc(GLenum func)
+{
+	if (changed(_depthFunc, func)) glDepthFunc(func);
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <vector>
+
+#include "defs.h"
+#include "GLdefs.h"
+#include "OStats.hpp"
+
+#ifndef OGPUTIMER_FRAMELATENCY
+#define OGPUTIMER_FRAMELATENCY	4
+#endif
+
+#ifndef OGPUTIMER_STATSSAMPLE
+#define OGPUTIMER_STATSSAMPLE	100
+#endif
+
+/**
+ \brief GPU time measurement of render passes.
+
+ Passes are timed with GL_TIMESTAMP query counters issued around each pass, which (unlike GL_TIME_ELAPSED) can be
+ nested. A pass may run several times in a frame, such as each mesh draw: its GPU time is the sum of all the
+ runs. Queries are kept in a ring of OGPUTIMER_FRAMELATENCY frames, and results are only read back when a frame
+ slot is reused, by which time the GPU has normally finished it, so the CPU never waits for the GPU. Frames whose
+ results are still not available are dropped instead.
+
+ The timer is disabled by default, and must only be used on the thread that holds the GL context. Timer queries
+ are core on OpenGL 3.3, and are also supported by Mesa's software rasterizer (llvmpipe).
+ */
+class OAPI OGPUTimer
+{
+public:
+	/**
+	 \brief Enables or disables the GPU timing.
+	 */
+	static void setEnabled(bool enabled);
+
+	/**
+	 \brief Returns true if the GPU timing is enabled.
+	 */
+	static bool enabled();
+
+	/**
+	 \brief Returns the identifier of a pass, registering it if needed.
+	 \param name Pass name. Must be a string with static storage, such as a literal.
+	 */
+	static int pass(const char* name);
+
+	/**
+	 \brief Marks the start of a pass on the GPU command stream.
+	 \param passId Pass identifier.
+	 \return Token to be passed to end(), or -1 if timing is disabled.
+	 */
+	static int begin(int passId);
+
+	/**
+	 \brief Marks the end of a pass on the GPU command stream.
+	 \param passId Pass identifier.
+	 \param token Value returned by the matching begin() call.
+	 */
+	static void end(int passId, int token);
+
+	/**
+	 \brief Closes the current frame, collecting the results of the oldest frame in the ring.
+
+	 Called by OApplication after each buffer swap.
+	 */
+	static void newFrame();
+
+	/**
+	 \brief Number of registered passes.
+	 */
+	static int passCount();
+
+	/**
+	 \brief Pass name.
+	 */
+	static const char* passName(int passId);
+
+	/**
+	 \brief GPU time per frame of a pass, in microseconds.
+	 */
+	static const OStats<float>& passStats(int passId);
+
+	/**
+	 \brief GPU time per frame of a pass, in microseconds, or NULL if the pass was not registered.
+	 */
+	static const OStats<float>* passStats(const char* name);
+
+	/**
+	 \brief Number of frames whose results were dropped because the GPU had not finished them.
+	 */
+	static int droppedFrameCount();
+
+	/**
+	 \brief Deletes the query objects. Must be called while the GL context still exists.
+	 */
+	static void release();
+
+private:
+	struct Pass {
+		const char* name;
+		OStats<float> stats;
+		std::vector<GLuint> queries[OGPUTIMER_FRAMELATENCY];
+		int used[OGPUTIMER_FRAMELATENCY];
+	};
+
+	static std::vector<Pass*> _passes;
+	static bool _enabled;
+	static int _frame;
+	static int _droppedFrameCount;
+};
+
+/**
+ \brief Times the GPU commands issued on the scope it is declared in. Meant to be used through the OGPUTIMER_SCOPE()
+	macro.
+ */
+class OAPI OGPUTimerScope
+{
+public:
+	/**
+	 \brief Class constructor. Marks the start of the pass.
+	 */
+	OGPUTimerScope(int passId);
+
+	/**
+	 \brief Class destructor. Marks the end of the pass.
+	 */
+	~OGPUTimerScope();
+
+private:
+	int _passId;
+	int _token;
+};
+
+#define OGPUTIMER_CONCAT_(a, b)	a##b
+#define OGPUTIMER_CONCAT(a, b)	OGPUTIMER_CONCAT_(a, b)
+#define OGPUTIMER_SCOPE(name)	static const int OGPUTIMER_CONCAT(_ogpuTimerPass, __LINE__) = OGPUTimer::pass(name); \
+				OGPUTimerScope OGPUTIMER_CONCAT(_ogpuTimerScope, __LINE__)(OGPUTIMER_CONCAT(_ogpuTimerPass, __LINE__))
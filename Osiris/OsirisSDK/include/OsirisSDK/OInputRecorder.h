@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "defs.h"
+#include "OEventQueue.h"
+
+#define OINPUTRECORDER_MAGIC	"OSIRISIN"
+#define OINPUTRECORDER_VERSION	1
+
+/**
+ \brief Records input events to a binary log file.
+
+ The log starts with an 8-byte magic string and a 32-bit version number, followed by one fixed-size entry
+ per event: the 64-bit simulation time offset in microseconds, the 32-bit event type and the 16-byte event
+ payload. Values are stored in the host byte order. Logs are played back by OInputReplay.
+ */
+class OAPI OInputRecorder
+{
+public:
+	/**
+	 \brief Log entry.
+	 */
+	struct OAPI Entry {
+		long long simulationTime_us;	/**< Simulation time offset, relative to the start of the recording. */
+		OEventQueue::Record record;	/**< Event record. */
+	};
+
+	/**
+	 \brief Class constructor.
+	 \param filename Log file name. Existing files are overwritten.
+	 \param startTime Simulation time index at which the recording starts.
+	 */
+	OInputRecorder(const char* filename, const OTimeIndex& startTime);
+
+	/**
+	 \brief Class destructor. Closes the log file.
+	 */
+	virtual ~OInputRecorder();
+
+	/**
+	 \brief Writes an event record to the log.
+	 \param simulationTime Simulation time index at which the event is delivered.
+	 \param rec Event record.
+	 */
+	void record(const OTimeIndex& simulationTime, const OEventQueue::Record& rec);
+
+	/**
+	 \brief Number of events recorded.
+	 */
+	int count() const;
+
+	/**
+	 \brief Writes an entry to a log file.
+	 \return False in case of error.
+	 */
+	static bool writeEntry(FILE* fp, const Entry& entry);
+
+	/**
+	 \brief Reads an entry from a log file.
+	 \return False at the end of the file or in case of error.
+	 */
+	static bool readEntry(FILE* fp, Entry* entry);
+
+private:
+	FILE* _fp;
+	long long _startTime_us;
+	int _count;
+};
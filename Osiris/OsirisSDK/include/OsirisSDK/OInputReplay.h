@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include "defs.h"
+#include "OInputRecorder.h"
+
+class OApplication;
+
+/**
+ \brief Plays back an input log written by OInputRecorder.
+
+ The whole log is loaded on construction. Events are injected into the application event queue once the
+ simulation reaches the time offset at which they were originally delivered. Combined with the application
+ fixed timestep mode, events reach their recipients on the same simulation steps as in the recording.
+
+ Events that don't fit in the event queue are dropped, and the replay no longer matches the recording: they are
+ counted by droppedCount().
+ */
+class OAPI OInputReplay
+{
+public:
+	/**
+	 \brief Class constructor.
+	 \param filename Log file name.
+	 \param startTime Simulation time index at which the replay starts.
+	 */
+	OInputReplay(const char* filename, const OTimeIndex& startTime);
+
+	/**
+	 \brief Class destructor.
+	 */
+	virtual ~OInputReplay();
+
+	/**
+	 \brief Queues all the events due up to the given simulation time index.
+	 \param app Application that will receive the events.
+	 \param simulationTime Current simulation time index.
+	 \return Number of events queued, not counting the ones dropped for a full queue.
+	 */
+	int inject(OApplication* app, const OTimeIndex& simulationTime);
+
+	/**
+	 \brief Returns true once all the events have been queued.
+	 */
+	bool finished() const;
+
+	/**
+	 \brief Total number of events in the log.
+	 */
+	int count() const;
+
+	/**
+	 \brief Number of events that could not be queued, since the event queue was full.
+	 */
+	int droppedCount() const;
+
+private:
+	std::vector<OInputRecorder::Entry> _entries;
+	size_t _next;
+	int _droppedCount;
+	long long _startTime_us;
+};
@@ -10,11 +10,20 @@
 #include "OCamera.h"
 #include "OMath.h"
 
+#ifndef OMESH_INSTANCEMTX_LOCATION
+#define OMESH_INSTANCEMTX_LOCATION	2
+#endif
+
 /**
  \brief Base class that represents a group of vertices that together make a geometrical shape.
 
  Meshes are first defined by entering vertex data and indices. The mesh object can then be initialized
  and then redered.
+
+ A mesh can also be rendered many times with a single draw call (see renderInstanced()). The model matrix of
+ each instance is streamed to the vertex shader as a mat4 attribute on location OMESH_INSTANCEMTX_LOCATION
+ (which takes up four consecutive locations), and the shader is told to apply it by the "instanced" boolean
+ uniform.
 */
 class OAPI OMesh : public ORenderObject
 {
@@ -91,10 +100,61 @@ public:
 
 	/**
 	 \brief Starts the rendering process for the object.
-	 \param mtx Pointer to the matrix stack that contains all the transformations.
+	 \param mtx Pointer to the matrix stack that contains the model transformations. The camera transformation is
+		    applied by the shader, from the camera uniform buffer (see OCamera).
 	*/
 	void render(OMatrixStack *mtx);
 
+	/**
+	 \brief Renders several instances of the object with a single draw call.
+	 \param mtx Pointer to the matrix stack with the model transformations shared by all instances.
+	 \param instanceMtx Model matrices of the instances, 16 floats each, in column-major order.
+	 \param instanceCount Number of instances.
+	*/
+	void renderInstanced(OMatrixStack *mtx, const float* instanceMtx, int instanceCount);
+
+	/**
+	 \brief Submits the object to a render queue, on the opaque or blended pass.
+	 \param queue Render queue.
+	 \param stack Pointer to the matrix stack that contains the model transformations. The item depth is
+		      calculated with the queue view-projection matrix.
+	*/
+	void submit(ORenderQueue* queue, OMatrixStack* stack);
+
+	/**
+	 \brief Submits several instances of the object to a render queue, as a single item.
+	 \param queue Render queue.
+	 \param stack Pointer to the matrix stack with the model transformations shared by all instances.
+	 \param instanceMtx Model matrices of the instances, 16 floats each, which must remain valid until the queue
+			    is executed.
+	 \param instanceCount Number of instances.
+	*/
+	void submitInstanced(ORenderQueue* queue, OMatrixStack* stack, const float* instanceMtx, int instanceCount);
+
+	/**
+	 \brief Draws an item submitted to a render queue.
+	 \param item Draw item.
+	 \param stateBound True if the previous item left the mesh and its shader program bound.
+	*/
+	void renderItem(const ORenderQueue::Item& item, bool stateBound);
+
+	/**
+	 \brief Provides the mesh bounding sphere, in model coordinates, calculated from the vertices by init().
+	 \return False if the mesh was not initialized yet.
+	*/
+	bool boundingSphere(OVector3& center, float& radius);
+
+	/**
+	 \brief Enables or disables blending. Blended meshes are drawn after the opaque ones by the render queue,
+		back-to-front.
+	*/
+	void setBlending(bool enabled);
+
+	/**
+	 \brief Returns true if the mesh is drawn with blending.
+	*/
+	bool blending() const;
+
 	/**
 	 \brief Sets which face will be rendered when face culling is available.
 	 \see setFaceCulling()
@@ -174,10 +234,36 @@ private:
 	OMeshBuffer<GLuint> _indexBuffer;
 
 	OShaderProgram* _program;
-	GLuint _transformMtxRef;
+	OShaderProgram::UniformHandle _modelMtxUniform;
+	OShaderProgram::UniformHandle _instancedUniform;
+
+	GLuint _instanceBufferObject;
+	size_t _instanceBufferCapacity;
+
+	bool _blending;
+
+	OVector3 _boundsCenter;
+	float _boundsRadius;
 
 	bool _cullEnabled;
 	CullFace _cullFace;
 	CullFront _cullFront;
+
+	/**
+	 \brief Uploads instance model matrices to the instance buffer.
+	*/
+	void uploadInstances(const float* instanceMtx, int instanceCount);
+
+	/**
+	 \brief Binds the vertex array object and the shader program, and sets the face culling state.
+	*/
+	void bindState();
+
+	/**
+	 \brief Sets the model matrix and issues the draw call, with the mesh state already bound.
+	 \param transform Model matrix.
+	 \param instanceCount Number of instances, from the instance buffer, or zero for a non-instanced draw.
+	*/
+	void draw(const OMatrix4x4& transform, int instanceCount);
 };
 
@@ -2,6 +2,7 @@
 
 #include "GLdefs.h"
 #include "defs.h"
+#include "OGLState.h"
 
 #ifndef OMESH_MALLOC_BLOCK
 #define OMESH_MALLOC_BLOCK	64
@@ -97,7 +98,7 @@ template<class BType>
 OMeshBuffer<BType>::~OMeshBuffer()
 {
 	free(_buffer);
-	if (_glBufferObject != 0) glDeleteBuffers(1, &_glBufferObject);
+	if (_glBufferObject != 0) OGLState::deleteBuffers(1, &_glBufferObject);
 }
 
 template<class BType>
@@ -156,9 +157,8 @@ GLuint OMeshBuffer<BType>::generateGLBufferObject(GLenum bufferType)
 {
 	glGenBuffers(1, &_glBufferObject);
 
-	glBindBuffer(bufferType, _glBufferObject);
+	OGLState::bindBuffer(bufferType, _glBufferObject);
 	glBufferData(bufferType, _itemCount*sizeof(BType), _buffer, GL_STATIC_DRAW);
-	glBindBuffer(bufferType, 0);
 
 	return _glBufferObject;
 }
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <functional>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "defs.h"
+#include "OMetricsLayout.h"
+#include "OStats.hpp"
+
+#ifndef OMETRICSEXPORTER_DEFAULT_INTERVAL_US
+#define OMETRICSEXPORTER_DEFAULT_INTERVAL_US	1000000
+#endif
+
+/**
+ \brief Exports metrics to a memory-mapped file, for external monitoring.
+
+ Each metric is either an OStats object, whose window statistics are exported, or a scalar value provided by a
+ function. On each export, the values are written into a fixed-layout shared file (see OMetricsLayout.h), one
+ record per metric, protected by a sequence lock: an external process maps the file and samples the records
+ without any system calls, and the export itself is just memory writes.
+
+ Optionally, each export is also appended to a file sink, as CSV rows or JSON lines.
+
+ Metrics must be added from the thread that calls update(), which is usually the main loop.
+ */
+class OAPI OMetricsExporter
+{
+public:
+	/**
+	 \brief File sink formats.
+	 */
+	enum SinkFormat {
+		CSVSink,		/**< One CSV row per export, with a header row; columns are metric averages and p99. */
+		JSONLinesSink		/**< One JSON object per export and line. */
+	};
+
+	/**
+	 \brief Scalar metric provider.
+	 */
+	typedef std::function<double()> ValueFunction;
+
+	/**
+	 \brief Class constructor. Creates (or truncates) and maps the metrics file.
+	 \param filename Metrics file name.
+	 \param interval_us Minimum interval between exports, in microseconds.
+	 */
+	OMetricsExporter(const char* filename, int interval_us=OMETRICSEXPORTER_DEFAULT_INTERVAL_US);
+
+	/**
+	 \brief Class destructor. Unmaps the file, which is left on disk with the last exported values.
+	 */
+	virtual ~OMetricsExporter();
+
+	/**
+	 \brief Adds a metric backed by an OStats object.
+	 \param name Metric name, up to OMETRICS_NAMELENGTH-1 characters.
+	 \param stats Statistics object, which must outlive the exporter.
+	 */
+	void addMetric(const char* name, const OStats<int>* stats);
+
+	/**
+	 \brief Adds a metric backed by an OStats object.
+	 \param name Metric name, up to OMETRICS_NAMELENGTH-1 characters.
+	 \param stats Statistics object, which must outlive the exporter.
+	 */
+	void addMetric(const char* name, const OStats<float>* stats);
+
+	/**
+	 \brief Adds a scalar metric.
+	 \param name Metric name, up to OMETRICS_NAMELENGTH-1 characters.
+	 \param function Function that provides the metric value.
+	 */
+	void addMetric(const char* name, ValueFunction function);
+
+	/**
+	 \brief Number of metrics.
+	 */
+	int metricCount() const;
+
+	/**
+	 \brief Sets the minimum interval between exports, in microseconds.
+	 */
+	void setInterval(int interval_us);
+
+	/**
+	 \brief Returns the minimum interval between exports, in microseconds.
+	 */
+	int interval() const;
+
+	/**
+	 \brief Opens a file sink, to which every export is appended.
+	 \param filename Sink file name.
+	 \param format Sink format.
+	 */
+	void openFileSink(const char* filename, SinkFormat format);
+
+	/**
+	 \brief Closes the file sink.
+	 */
+	void closeFileSink();
+
+	/**
+	 \brief Exports the metrics if the export interval has elapsed since the last export.
+	 \return True if the metrics were exported.
+	 */
+	bool update();
+
+	/**
+	 \brief Exports the metrics.
+	 */
+	void exportMetrics();
+
+	/**
+	 \brief Returns the resident memory of the current process, in bytes, or zero if unavailable.
+	 */
+	static long long processMemory();
+
+private:
+	struct Metric {
+		std::string name;
+		std::function<void(OMetricsValues*)> sample;
+	};
+
+	std::vector<Metric> _metrics;
+	OMetricsFile* _file;
+	int _interval_us;
+	long long _lastExport_ns;
+	FILE* _sink;
+	SinkFormat _sinkFormat;
+	bool _sinkHeaderWritten;
+#ifdef WIN32
+	void* _fileHandle;
+	void* _mappingHandle;
+#else
+	int _fd;
+#endif
+
+	void addRecord(const char* name, const std::function<void(OMetricsValues*)>& sample);
+	void writeSink(const std::vector<OMetricsValues>& values, long long timestamp_us);
+
+	template <class VType> static void sampleStats(const OStats<VType>* stats, OMetricsValues* values);
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <string.h>
+
+/*
+ * Layout of the metrics file written by OMetricsExporter. This header has no dependencies on the rest of the SDK,
+ * so that external monitoring tools can include it alone.
+ */
+
+#ifndef OMETRICS_MAXRECORDS
+#define OMETRICS_MAXRECORDS	64
+#endif
+
+#define OMETRICS_MAGIC		"OSIRISMT"
+#define OMETRICS_VERSION	1
+#define OMETRICS_NAMELENGTH	48
+
+/**
+ \brief Metrics file header.
+ */
+struct OMetricsHeader {
+	char magic[8];					/**< OMETRICS_MAGIC, not null-terminated. */
+	unsigned int version;				/**< OMETRICS_VERSION. */
+	unsigned int recordCapacity;			/**< Number of record slots on the file. */
+	unsigned int recordSize;			/**< Size of each record, in bytes. */
+	unsigned int processId;				/**< Exporting process identifier. */
+	std::atomic<unsigned int> recordCount;		/**< Number of registered records. */
+	std::atomic<unsigned int> updateCount;		/**< Number of exports so far. */
+};
+
+/**
+ \brief Metric values. For scalar metrics, all the statistics hold the same value.
+ */
+struct OMetricsValues {
+	long long timestamp_us;				/**< Time of the export, on the OTimeIndex timeline. */
+	int sampleCount;				/**< Number of samples on the statistics window. */
+	float last;					/**< Most recent sample. */
+	float average;					/**< Window average. */
+	float stdev;					/**< Window standard deviation. */
+	float minValue;					/**< Window minimum. */
+	float maxValue;					/**< Window maximum. */
+	float p50;					/**< Window median. */
+	float p99;					/**< Window 99th percentile. */
+};
+
+/**
+ \brief Metric record, protected by a sequence lock.
+
+ The exporter makes the sequence odd while it writes the values and even again once it is done. Readers copy the
+ values and retry if the sequence was odd or changed during the copy. The name is written before the record is
+ counted on the header, and does not change afterwards.
+ */
+struct OMetricsRecord {
+	std::atomic<unsigned int> sequence;		/**< Sequence lock counter. */
+	char name[OMETRICS_NAMELENGTH];			/**< Metric name, null-terminated. */
+	OMetricsValues values;				/**< Metric values. */
+};
+
+/**
+ \brief Whole metrics file.
+ */
+struct OMetricsFile {
+	OMetricsHeader header;
+	OMetricsRecord records[OMETRICS_MAXRECORDS];
+};
+
+/**
+ \brief Writes the values of a record (exporter side).
+ */
+inline void OMetricsWriteRecord(OMetricsRecord* record, const OMetricsValues& values)
+{
+	unsigned int seq = record->sequence.load(std::memory_order_relaxed);
+	record->sequence.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(&record->values, &values, sizeof(values));
+	record->sequence.store(seq + 2, std::memory_order_release);
+}
+
+/**
+ \brief Reads a consistent copy of the values of a record (reader side).
+ \param record Record to be read.
+ \param values Output values.
+ \param maxRetries Maximum number of attempts, in case the exporter keeps the record locked (e.g. it died while
+		   writing it).
+ \return False if no consistent copy could be taken.
+ */
+inline bool OMetricsReadRecord(const OMetricsRecord* record, OMetricsValues* values, int maxRetries=1000)
+{
+	for (int i = 0; i < maxRetries; i++) {
+		unsigned int seq = record->sequence.load(std::memory_order_acquire);
+		if (seq & 1) continue;
+		memcpy(values, (const void*)&record->values, sizeof(*values));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (record->sequence.load(std::memory_order_relaxed) == seq) return true;
+	}
+	return false;
+}
@@ -5,6 +5,8 @@
 #include "defs.h"
 #include "OEvent.h"
 
+class OTimeIndex;
+
 /**
  \brief Base OsirisSDK class.
 
@@ -40,6 +42,25 @@ public:
 	 */
 	virtual void processEvent(const OEvent* evt);
 
+	/**
+	 \brief Tells whether processEvent() may be called concurrently with other recipients of the same event.
+
+	 Thread-safe recipients may have events delivered by OApplication worker threads when parallel event
+	 dispatch is enabled. By default, objects are not thread-safe.
+	 */
+	virtual bool isEventThreadSafe() const;
+
+	/**
+	 \brief Main timer handle.
+
+	 This is meant to be called by the OApplication timer wheel when a timer scheduled for this object fires.
+	 From here the onTimer() handler is called, but can be overriden if necessary.
+
+	 \param timerId Timer identifier given when it was scheduled.
+	 \param timeIndex Simulation time index.
+	 */
+	virtual void processTimer(int timerId, const OTimeIndex& timeIndex);
+
 protected:
 	/**
 	 \brief Keyboard press event handler.
@@ -86,4 +107,14 @@ protected:
 	 */
 	virtual void onScreenResize(const OResizeEvent* evt);
 
+	/**
+	 \brief Timer handler.
+
+	 This handler is only called for timers scheduled with OApplication::scheduleTimer(). By default does nothing.
+
+	 \param timerId Timer identifier given when it was scheduled.
+	 \param timeIndex Simulation time index.
+	 */
+	virtual void onTimer(int timerId, const OTimeIndex& timeIndex);
+
 };
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <vector>
+
+#include "defs.h"
+#include "OMath.h"
+
+class OMesh;
+class OThreadPool;
+
+#ifndef OOCCLUSIONCULLER_WIDTH
+#define OOCCLUSIONCULLER_WIDTH		256
+#endif
+
+#ifndef OOCCLUSIONCULLER_HEIGHT
+#define OOCCLUSIONCULLER_HEIGHT		128
+#endif
+
+#ifndef OOCCLUSIONCULLER_BANDHEIGHT
+#define OOCCLUSIONCULLER_BANDHEIGHT	16
+#endif
+
+/**
+ \brief Software occlusion culling, with a depth buffer rasterized on the CPU.
+
+ Occluders, low-poly meshes that lie inside of the objects they stand for, are rasterized into a small depth
+ buffer, in horizontal bands of OOCCLUSIONCULLER_BANDHEIGHT rows that are handed to the threads of a thread pool,
+ four pixels at a time with SSE instructions where available. Objects are then tested by the screen-space box of
+ their bounding spheres: an object is occluded if every pixel of the box has an occluder in front of its nearest
+ point.
+
+ The test is conservative: occluder triangles that cross the camera near plane are left out, as are objects that
+ cross it. Nothing here depends on the GPU, so the pass works the same way with software GL implementations.
+
+ Usage, once per frame: begin(), addOccluder() for each occluder, rasterize() and then isOccluded() for each
+ candidate object, which may be called from several threads at once.
+ */
+class OAPI OOcclusionCuller
+{
+public:
+	/**
+	 \brief Class constructor.
+	 \param width Depth buffer width in pixels, rounded up to a multiple of four.
+	 \param height Depth buffer height in pixels.
+	 */
+	OOcclusionCuller(int width=OOCCLUSIONCULLER_WIDTH, int height=OOCCLUSIONCULLER_HEIGHT);
+
+	/**
+	 \brief Class destructor.
+	 */
+	virtual ~OOcclusionCuller();
+
+	/**
+	 \brief Returns the depth buffer width.
+	 */
+	int width() const;
+
+	/**
+	 \brief Returns the depth buffer height.
+	 */
+	int height() const;
+
+	/**
+	 \brief Starts a frame: clears the occluders and the depth buffer.
+	 \param viewProjection Camera view-projection matrix.
+	 */
+	void begin(const OMatrix4x4& viewProjection);
+
+	/**
+	 \brief Adds an occluder.
+	 \param mesh Occluder mesh: only its vertex and index data are used.
+	 \param model Occluder model transformation.
+	 */
+	void addOccluder(OMesh* mesh, const OMatrix4x4& model);
+
+	/**
+	 \brief Rasterizes the occluders into the depth buffer.
+	 \param pool Thread pool that rasterizes the bands in parallel, or NULL to rasterize on the calling thread.
+	 */
+	void rasterize(OThreadPool* pool=NULL);
+
+	/**
+	 \brief Returns true if a sphere is hidden by the occluders.
+	 \param center Sphere center, in scene coordinates.
+	 \param radius Sphere radius.
+	 */
+	bool isOccluded(const OVector3& center, float radius) const;
+
+	/**
+	 \brief Number of occluder triangles rasterized on the current frame.
+	 */
+	int triangleCount() const;
+
+	/**
+	 \brief Returns the depth buffer, width() x height() values of normalized device depth, bottom row first.
+	 */
+	const float* depthBuffer() const;
+
+private:
+	/* triangle setup: edge functions and depth plane, evaluated as a*x + b*y + c on pixel centers */
+	struct Triangle {
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+		float depthA;
+		float depthB;
+		float depthC;
+		int minX;
+		int maxX;
+		int minY;
+		int maxY;
+	};
+
+	int _width;
+	int _height;
+	std::vector<float> _depth;
+	OMatrix4x4 _viewProjection;
+	std::vector<Triangle> _triangles;
+
+	/* occluder vertices in screen space, and whether they could be projected (scratch buffers) */
+	std::vector<float> _screen;
+	std::vector<unsigned char> _projected;
+
+	/**
+	 \brief Rasterizes the triangles that overlap rows [rowBegin, rowEnd).
+	 */
+	void rasterizeBand(int rowBegin, int rowEnd);
+
+	/**
+	 \brief Projects a point to screen space: x and y in pixels, and z as normalized device depth.
+	 \return False if the point is behind (or too close to) the camera.
+	 */
+	bool project(const GLfloat* mtx, float x, float y, float z, float* out) const;
+};
+
@@ -1,22 +1,50 @@
 #pragma once
 
+#include <assert.h>
+
+#include "defs.h"
+#include "OParameterSchema.h"
+
+/**
+ @brief Compile-time parameter handle.
+
+ Handles bind a parameter index to its value type, so that reading the parameter from an
+ OParameterList resolves to a single load from the slot array, without any bounds or type checks (debug
+ builds assert that the handle type matches the schema).
+ They are meant to be declared by behaviors as typedefs, next to the parameter index enumeration:
+
+ \code
+ typedef OParameterHandle<float, attrMinX> MinX;
+ float minX = attributes->get(MinX());
+ \endcode
+
+ \tparam T Parameter value type: bool, int, float or const char*.
+ \tparam Index Parameter index, as defined in the OParameterSchema.
+ */
+template <class T, int Index> struct OParameterHandle {
+	enum { index = Index };
+};
+
 /**
  @brief Parameter list class.
 
  This class was designed to be used by OEntity class objects, in order to store an entity's list of
  parameters.
 
- Be aware that this class uses an internal vector to store the parameters, and the indeces must be 
- sequential.
+ The parameter layout (types and default values) is given by an OParameterSchema object, shared by all
+ the entities of the same kind. The list itself only stores the values, one slot per parameter.
+ Type checks are done when values are set by index, while reads through OParameterHandle objects are
+ unchecked.
  */
 class OAPI OParameterList
 {
 public:
 	/**
 	 @brief Class constructor.
-	 @param count Parameter count.
+	 @param schema Parameter schema. The list is initialized with the schema default values. The schema
+		       must outlive the list.
 	 */
-	OParameterList(int count=0);
+	OParameterList(const OParameterSchema* schema);
 
 	/**
 	 @brief Class destructor.
@@ -24,156 +52,9 @@ public:
 	virtual ~OParameterList();
 
 	/**
-	 @brief Generic parameter sub-class.
-
-	 This class will store an parameter inside the parameter list. The parameter necessarily
-	 has a type and value. In case of strings the value is dinamically allocated. 
-	 
-	 If no type is assigned, objects will be initialized as Parameter:Unitialized. After a type
-	 is assigned, the object will remain as the same time throughout it's entire lifetime. In case
-	 a method related to a type other than the object's, an OException will be thrown.
-	 */
-	class OAPI Parameter {
-	public:
-		/**
-		 @brief Class constructor.
-		 */
-		Parameter();
-
-		/**
-		 @brief Class copy constructor.
-		 */
-		Parameter(const Parameter& in);
-
-		/**
-		 @brief Class constructor, object initialized as boolean.
-		 */
-		Parameter(bool val);
-
-		/**
-		 @brief Class constructor, object initialized as integer.
-		 */
-		Parameter(int val);
-
-		/**
-		 @brief Class constructor, object initialized as float.
-		 */
-		Parameter(float val);
-
-		/**
-		 @brief Class constructor, object initialized as string.
-		 */
-		Parameter(const char* val);
-
-		/**
-		 @brief Class destructor. 
-		 */
-		virtual ~Parameter();
-
-		/**
-		 @brief Parameter types.
-		 */
-		enum Type {
-			Uninitialized,	/**< Unitialized parameter, no type defined. */
-			Boolean,	/**< Boolean parameter. */
-			Integer,	/**< Integer parameter. */
-			Float,		/**< Float parameter */
-			String		/**< String parameter */
-		};	
-
-		/**
-		 @brief Returns the parameter type.
-		 */
-		Type type() const;
-
-		/**
-		 @brief Value retrieval method for boolean parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		bool boolVal() const;
-
-		/**
-		 @brief Value retrieval method for integer parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		int intVal() const;
-
-		/**
-		 @brief Value retrieval method for float parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		float floatVal() const;
-
-		/**
-		 @brief Value retrieval method for string parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		const char* strVal() const;
-
-		/**
-		 @brief Value setting method for boolean parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		void setVal(bool val);
-
-		/**
-		 @brief Value setting method for integer parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		void setVal(int val);
-
-		/**
-		 @brief Value setting method for float parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		void setVal(float val);
-
-		/**
-		 @brief Value setting method for string parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		void setVal(const char* val);
-
-		/**
-		 @brief Assignment operator, copying another parameter. 
-		 @throws OException In case of parameter type mismatch.
-		 */
-		Parameter& operator=(const Parameter& in);
-
-		/**
-		 @brief Assignment operator for boolean parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		Parameter& operator=(bool in);
-
-		/**
-		 @brief Assignment operator for integer parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		Parameter& operator=(int in);
-
-		/**
-		 @brief Assignment operator for float parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		Parameter& operator=(float in);
-
-		/**
-		 @brief Assignment operator for string parameters.
-		 @throws OException In case of parameter type mismatch.
-		 */
-		Parameter& operator=(const char* in);
-
-	private:
-		union {
-			bool _bool;
-			int _int;
-			float _float;
-			char* _str;
-		} _value;
-
-		Type _type;
-	};
+	 @brief Returns the parameter schema.
+	 */
+	const OParameterSchema* schema() const;
 
 	/**
 	 @brief Returns the number of parameters in the list.
@@ -181,18 +62,90 @@ public:
 	int count() const;
 
 	/**
-	 @brief Parameter fetch method.
-	 @param idx Parameter index.
+	 @brief Value retrieval method for boolean parameters.
+	 @throws OException In case of parameter index or type mismatch.
+	 */
+	bool boolVal(int idx) const;
+
+	/**
+	 @brief Value retrieval method for integer parameters.
+	 @throws OException In case of parameter index or type mismatch.
+	 */
+	int intVal(int idx) const;
+
+	/**
+	 @brief Value retrieval method for float parameters.
+	 @throws OException In case of parameter index or type mismatch.
+	 */
+	float floatVal(int idx) const;
+
+	/**
+	 @brief Value retrieval method for string parameters.
+	 @throws OException In case of parameter index or type mismatch.
+	 */
+	const char* strVal(int idx) const;
+
+	/**
+	 @brief Value setting method for boolean parameters.
+	 @throws OException In case of parameter index or type mismatch.
+	 */
+	void setVal(int idx, bool val);
+
+	/**
+	 @brief Value setting method for integer parameters.
+	 @throws OException In case of parameter index or type mismatch.
+	 */
+	void setVal(int idx, int val);
+
+	/**
+	 @brief Value setting method for float parameters.
+	 @throws OException In case of parameter index or type mismatch.
+	 */
+	void setVal(int idx, float val);
+
+	/**
+	 @brief Value setting method for string parameters. The string is interned.
+	 @throws OException In case of parameter index or type mismatch.
+	 */
+	void setVal(int idx, const char* val);
+
+	/**
+	 @brief Unchecked boolean parameter access.
+	 */
+	template <int Index> bool& get(OParameterHandle<bool, Index>)
+	{
+		assert(_schema->type(Index) == OParameterSchema::Boolean);
+		return _slots[Index].boolVal;
+	}
+
+	/**
+	 @brief Unchecked integer parameter access.
+	 */
+	template <int Index> int& get(OParameterHandle<int, Index>)
+	{
+		assert(_schema->type(Index) == OParameterSchema::Integer);
+		return _slots[Index].intVal;
+	}
+
+	/**
+	 @brief Unchecked float parameter access.
 	 */
-	Parameter& get(int idx);
+	template <int Index> float& get(OParameterHandle<float, Index>)
+	{
+		assert(_schema->type(Index) == OParameterSchema::Float);
+		return _slots[Index].floatVal;
+	}
 
 	/**
-	 @brief Parameter fetch operator.
-	 @param idx Parameter index.
+	 @brief Unchecked string parameter access.
 	 */
-	Parameter& operator[](int idx);
+	template <int Index> const char* get(OParameterHandle<const char*, Index>) const
+	{
+		assert(_schema->type(Index) == OParameterSchema::String);
+		return _slots[Index].strVal;
+	}
 
 private:
-	Parameter* _attrs;
-	int _attrCount;
+	const OParameterSchema* _schema;
+	OParameterSchema::Slot* _slots;
 };
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+#include <set>
+#include <string>
+#include <mutex>
+
+#include "defs.h"
+
+/**
+ @brief Parameter schema class.
+
+ A schema describes the parameter layout shared by all entities of a kind: how many parameters
+ there are, their types and default values. OParameterList objects only store the values, packed
+ in an untyped slot array, while the type information lives here, once per kind of entity.
+
+ String values are interned in a process-wide table, so that all entities holding the same string
+ refer to a single copy of it. Interned strings are never released, so they can be read without locking.
+ */
+class OAPI OParameterSchema
+{
+public:
+	/**
+	 @brief Parameter types.
+	 */
+	enum Type {
+		Uninitialized,	/**< Parameter not defined in the schema. */
+		Boolean,	/**< Boolean parameter. */
+		Integer,	/**< Integer parameter. */
+		Float,		/**< Float parameter. */
+		String		/**< Interned string parameter. */
+	};
+
+	/**
+	 @brief Parameter storage slot.
+
+	 Every parameter takes a single slot, regardless of its type. Strings are stored as pointers
+	 to their interned copies.
+	 */
+	union Slot {
+		bool boolVal;		/**< Boolean value. */
+		int intVal;		/**< Integer value. */
+		float floatVal;		/**< Float value. */
+		const char* strVal;	/**< Interned string. */
+	};
+
+	/**
+	 @brief Class constructor.
+	 @param name Schema name, used in error messages.
+	 */
+	OParameterSchema(const char* name);
+
+	/**
+	 @brief Class destructor.
+	 */
+	virtual ~OParameterSchema();
+
+	/**
+	 @brief Returns the schema name.
+	 */
+	const char* name() const;
+
+	/**
+	 @brief Returns the number of parameters defined in the schema.
+	 */
+	int count() const;
+
+	/**
+	 @brief Returns the type of a given parameter.
+	 @param idx Parameter index.
+	 */
+	Type type(int idx) const;
+
+	/**
+	 @brief Defines a boolean parameter.
+	 @param idx Parameter index.
+	 @param defaultValue Value assigned to the parameter when a new list is created.
+	 @throws OException If the parameter was previously defined with another type.
+	 */
+	void define(int idx, bool defaultValue);
+
+	/**
+	 @brief Defines an integer parameter.
+	 @param idx Parameter index.
+	 @param defaultValue Value assigned to the parameter when a new list is created.
+	 @throws OException If the parameter was previously defined with another type.
+	 */
+	void define(int idx, int defaultValue);
+
+	/**
+	 @brief Defines a float parameter.
+	 @param idx Parameter index.
+	 @param defaultValue Value assigned to the parameter when a new list is created.
+	 @throws OException If the parameter was previously defined with another type.
+	 */
+	void define(int idx, float defaultValue);
+
+	/**
+	 @brief Defines a string parameter.
+	 @param idx Parameter index.
+	 @param defaultValue Value assigned to the parameter when a new list is created.
+	 @throws OException If the parameter was previously defined with another type.
+	 */
+	void define(int idx, const char* defaultValue);
+
+	/**
+	 @brief Returns the default values slot array, with count() items.
+	 */
+	const Slot* defaults() const;
+
+	/**
+	 @brief Checks if a parameter exists and has a given type.
+	 @throws OException In case of parameter index or type mismatch.
+	 */
+	void check(int idx, Type type) const;
+
+	/**
+	 @brief Interns a string.
+	 @param str String to be interned.
+	 @return Interned copy of the string, valid until the process ends. The same string always yields the
+		 same copy.
+	 */
+	static const char* intern(const char* str);
+
+private:
+	std::string _name;
+	std::vector<Type> _types;
+	std::vector<Slot> _defaults;
+
+	static std::mutex _internMutex;
+	static std::set<std::string> _internSet;
+
+	/**
+	 @brief Defines a parameter type, growing the layout if needed.
+	 */
+	Slot& define(int idx, Type type);
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <vector>
+
+#include "defs.h"
+#include "GLdefs.h"
+#include "ORenderObject.h"
+#include "OShaderProgram.h"
+#include "OStats.hpp"
+
+class OApplication;
+class OFont;
+class OText2D;
+
+#ifndef OPERFOVERLAY_HISTORY
+#define OPERFOVERLAY_HISTORY		120
+#endif
+
+#ifndef OPERFOVERLAY_DEFAULT_SCALE_US
+#define OPERFOVERLAY_DEFAULT_SCALE_US	33333
+#endif
+
+#ifndef OPERFOVERLAY_DEFAULT_BUDGET_US
+#define OPERFOVERLAY_DEFAULT_BUDGET_US	16667
+#endif
+
+#ifndef OPERFOVERLAY_TEXTINTERVAL_US
+#define OPERFOVERLAY_TEXTINTERVAL_US	250000
+#endif
+
+/**
+ \brief Performance overlay.
+
+ Draws rolling graphs of the last OPERFOVERLAY_HISTORY frame, simulation and render times of an application,
+ along with a frame budget line (the target frame interval, or OPERFOVERLAY_DEFAULT_BUDGET_US if there is no
+ target frame rate), and a text readout with averages and percentiles of the application statistics,
+ entity count (for OSimulation applications), event rate, GL draw count (if OGLCounters is enabled) and GPU
+ time (if OGPUTimer is enabled).
+
+ All the graphs are kept in a single line strip vertex buffer, uploaded once and drawn with a single call per
+ frame. The text is only reformatted every OPERFOVERLAY_TEXTINTERVAL_US microseconds. The CPU time the overlay
+ itself takes to render is measured and shown on the readout, so that it can be told apart from the application
+ cost; its GPU time is reported as the "OPerfOverlay" OGPUTimer pass.
+
+ Positions and sizes are given in normalized device coordinates, from -1.0 to 1.0.
+ */
+class OAPI OPerfOverlay : public ORenderObject
+{
+public:
+	/**
+	 \brief Class constructor.
+	 \param app Application being monitored.
+	 \param font Font used on the text readout.
+	 \param fontSize Font height in pixels.
+	 */
+	OPerfOverlay(OApplication* app, OFont* font, unsigned int fontSize=12);
+
+	/**
+	 \brief Class destructor.
+	 */
+	virtual ~OPerfOverlay();
+
+	/**
+	 \brief Sets the graph area.
+	 \param x Left edge position.
+	 \param y Bottom edge position.
+	 \param width Area width.
+	 \param height Area height.
+	 */
+	void setGraphArea(float x, float y, float width, float height);
+
+	/**
+	 \brief Sets the position of the text readout (top left corner).
+	 */
+	void setTextPosition(float x, float y);
+
+	/**
+	 \brief Sets the time that corresponds to the graph area height, in microseconds.
+	 */
+	void setScale(int scale_us);
+
+	/**
+	 \brief Returns the time that corresponds to the graph area height, in microseconds.
+	 */
+	int scale() const;
+
+	/**
+	 \brief Statistics of the CPU time taken to render the overlay, in microseconds.
+	 */
+	const OStats<float>& costStats() const;
+
+	/**
+	 \brief Renders the overlay.
+	 */
+	void render(OMatrixStack* mtx=NULL);
+
+private:
+	enum Graph {
+		FrameTimeGraph=0,
+		SimulationTimeGraph,
+		RenderTimeGraph,
+		GraphCount
+	};
+
+	enum {
+		BudgetLine = GraphCount,
+		Frame,
+		StripCount
+	};
+
+	struct Vertex {
+		float x;
+		float y;
+		float color[4];
+	};
+
+	OApplication* _app;
+	OText2D* _text;
+	float _x;
+	float _y;
+	float _width;
+	float _height;
+	int _scale_us;
+	int _history[GraphCount][OPERFOVERLAY_HISTORY];
+	int _historyHead;
+	std::vector<Vertex> _vertices;
+	GLint _stripFirst[StripCount];
+	GLsizei _stripCount[StripCount];
+	GLuint _arrayObject;
+	GLuint _vertexBuffer;
+	OStats<float> _costStats;
+	long long _lastTextUpdate_ns;
+	int _eventCount;
+
+	void sample();
+	void updateVertices();
+	void updateText(long long now_ns);
+	void setVertex(int idx, float x, float y, const float* color);
+
+	/* static properties and methods */
+	static OShaderProgram *_shaderProgram;
+	static const float _stripColors[StripCount][4];
+
+	/**
+	 \brief Compiles the shader program shared by all class objects.
+	 */
+	static void _Init();
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "defs.h"
+
+#ifndef OPROFILER_BUFFERSIZE
+#define OPROFILER_BUFFERSIZE	65536
+#endif
+
+/**
+ \brief Scoped CPU profiler.
+
+ Code is instrumented with the OPROFILE_ZONE() macro, which times the enclosing scope. Each thread writes the
+ zones it completes into its own ring buffer of OPROFILER_BUFFERSIZE entries, without locks; only the first
+ zone of a thread takes a lock, to register the thread buffer. Once a buffer is full, the oldest zones are
+ overwritten.
+
+ The recorded zones can be exported as a Chrome trace-event JSON file (to be opened on chrome://tracing or
+ similar viewers), where nested zones show up as a hierarchy.
+
+ The instrumentation is only compiled when OSIRIS_PROFILER is defined (CMake option OSIRIS_PROFILER);
+ otherwise OPROFILE_ZONE() expands to nothing.
+ */
+class OAPI OProfiler
+{
+public:
+	/**
+	 \brief Records a completed zone on the calling thread buffer.
+	 \param name Zone name. Must be a string with static storage, such as a literal.
+	 \param start_us Zone start time index in microseconds.
+	 \param end_us Zone end time index in microseconds.
+	 */
+	static void record(const char* name, long long start_us, long long end_us);
+
+	/**
+	 \brief Discards all recorded zones.
+	 */
+	static void clear();
+
+	/**
+	 \brief Exports the recorded zones to a Chrome trace-event JSON file.
+	 \param filename Output file name.
+	 \return False if the file could not be written.
+	 */
+	static bool exportChromeTrace(const char* filename);
+
+private:
+	struct Zone {
+		const char* name;
+		long long start_us;
+		long long end_us;
+	};
+
+	struct ThreadBuffer {
+		int threadId;
+		std::atomic<unsigned long long> head;
+		std::atomic<unsigned long long> base;
+		Zone zones[OPROFILER_BUFFERSIZE];
+	};
+
+	static std::mutex _buffersMutex;
+	static std::vector<ThreadBuffer*> _buffers;
+
+	static ThreadBuffer* threadBuffer();
+};
+
+/**
+ \brief Times the scope it is declared in. Meant to be used through the OPROFILE_ZONE() macro.
+ */
+class OAPI OProfileZone
+{
+public:
+	/**
+	 \brief Class constructor. Starts timing the zone.
+	 \param name Zone name. Must be a string with static storage, such as a literal.
+	 */
+	OProfileZone(const char* name);
+
+	/**
+	 \brief Class destructor. Records the zone.
+	 */
+	~OProfileZone();
+
+private:
+	const char* _name;
+	long long _startTicks;
+};
+
+#ifdef OSIRIS_PROFILER
+#	define OPROFILE_CONCAT_(a, b)	a##b
+#	define OPROFILE_CONCAT(a, b)	OPROFILE_CONCAT_(a, b)
+#	define OPROFILE_ZONE(name)	OProfileZone OPROFILE_CONCAT(_oprofileZone, __LINE__)(name)
+#else
+#	define OPROFILE_ZONE(name)
+#endif
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "defs.h"
+#include "ORenderQueue.h"
 
 class OMatrixStack;
 
 /**
  @brief Common interface for objects capable of rendering.
+
+ Objects can either be rendered right away, with render(), or through a render queue: submit() adds the object
+ draw items to the queue, which later draws them in sort order with renderItem().
  */
 class OAPI ORenderObject
 {
@@ -37,10 +41,48 @@ public:
 
 	/**
 	 @brief Renderization call.
-	 @param stack Matrix stack containing transformations to be applied to the object.
+	 @param stack Matrix stack containing the model transformations to be applied to the object. It doesn't include
+		the camera transformation, which the shaders take from the camera uniform buffer (see OCamera).
 	 */
 	virtual void render(OMatrixStack* stack) = 0;
 
+	/**
+	 @brief Submits the object draw items to a render queue.
+
+	 The default implementation submits a single overlay item, so the object is rendered with render() after the
+	 scene, in submission order.
+	 @param queue Render queue.
+	 @param stack Matrix stack containing the model transformations to be applied to the object.
+	 */
+	virtual void submit(ORenderQueue* queue, OMatrixStack* stack);
+
+	/**
+	 @brief Draws an item submitted by the object, when the render queue is executed.
+
+	 The default implementation calls render() with the item transformation.
+	 @param item Draw item.
+	 @param stateBound True if the previous item left the same shader program and mesh bound.
+	 */
+	virtual void renderItem(const ORenderQueue::Item& item, bool stateBound);
+
+	/**
+	 @brief Provides the object bounding sphere, used for view-frustum culling.
+
+	 The default implementation provides no bounds, so the object is never culled.
+	 @param center Sphere center, in scene coordinates.
+	 @param radius Sphere radius.
+	 @return True if the object has bounds.
+	 */
+	virtual bool boundingSphere(OVector3& center, float& radius);
+
+protected:
+	/**
+	 @brief Called by show() and hide() when the object is actually shown or hidden.
+
+	 The default implementation does nothing.
+	 */
+	virtual void onVisibilityChange();
+
 private:
 	bool _hidden;
 };
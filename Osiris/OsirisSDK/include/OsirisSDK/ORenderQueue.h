@@ -0,0 +1,142 @@
+#pragma once
+
+#include <vector>
+
+#include "defs.h"
+#include "OMath.h"
+
+class ORenderObject;
+
+/**
+ \brief Sorted queue of draw items.
+
+ Instead of rendering right away, render objects submit draw items to the queue (see ORenderObject::submit()).
+ Once every object has submitted its items, the queue is sorted and executed. Each item is tagged with a 64-bit
+ sort key built from:
+ - the render pass: opaque items first, then blended items and finally the screen overlay;
+ - the shader program and the mesh (vertex array object), so that items sharing them are drawn in sequence;
+ - the item depth: opaque items are drawn front-to-back, to take advantage of early depth rejection, and blended
+   items back-to-front, so they compose correctly. Overlay items keep the order in which they were submitted.
+
+ Keys are sorted with a LSD radix sort, skipping the key bytes that are the same for all items. The blending and
+ depth write state is set once per pass, and an item is told whether the previous one left its program and mesh
+ bound, so it can skip binding them again.
+ */
+class OAPI ORenderQueue
+{
+public:
+	/**
+	 \brief Render passes, in execution order.
+	 */
+	enum Pass {
+		Pass_Opaque=0,		/**< Opaque geometry, with depth writes and without blending. */
+		Pass_Blended,		/**< Translucent geometry, blended and without depth writes. */
+		Pass_Overlay,		/**< Screen overlay (i.e. text), blended and kept in submission order. */
+		PassCount
+	};
+
+	/**
+	 \brief Draw item sort key.
+	 */
+	typedef unsigned long long SortKey;
+
+	/**
+	 \brief Draw item.
+	 */
+	struct Item {
+		SortKey key;			/**< Sort key. */
+		Pass pass;			/**< Render pass. */
+		unsigned int program;		/**< Shader program GL reference, or zero if unknown. */
+		unsigned int mesh;		/**< Vertex array object GL reference, or zero if unknown. */
+		ORenderObject* object;		/**< Object that submitted the item, and that will draw it. */
+		OMatrix4x4 transform;		/**< Transformation matrix at the time of the submission. */
+		const float* instanceMtx;	/**< Instance model matrices, if instanced. */
+		int instanceCount;		/**< Number of instances, or zero if not instanced. */
+	};
+
+	/**
+	 \brief Class constructor.
+	 */
+	ORenderQueue();
+
+	/**
+	 \brief Class destructor.
+	 */
+	virtual ~ORenderQueue();
+
+	/**
+	 \brief Submits a draw item.
+	 \param object Object that will draw the item, through ORenderObject::renderItem().
+	 \param transform Model transformation matrix.
+	 \param pass Render pass.
+	 \param program Shader program GL reference, or zero if unknown.
+	 \param mesh Vertex array object GL reference, or zero if unknown.
+	 \param depth Item depth, as its distance from the camera.
+	 \param instanceMtx Instance model matrices, 16 floats each, which must remain valid until the queue is executed.
+	 \param instanceCount Number of instances, or zero if not instanced.
+	 */
+	void submit(ORenderObject* object, const OMatrix4x4& transform, Pass pass, unsigned int program=0,
+		    unsigned int mesh=0, float depth=0.0f, const float* instanceMtx=NULL, int instanceCount=0);
+
+	/**
+	 \brief Sets the camera view-projection matrix, used by objects to calculate the depth of their items.
+	 */
+	void setViewProjection(const OMatrix4x4& viewProjection);
+
+	/**
+	 \brief Returns the camera view-projection matrix.
+	 */
+	const OMatrix4x4& viewProjection() const;
+
+	/**
+	 \brief Removes all items.
+	 */
+	void clear();
+
+	/**
+	 \brief Returns the number of submitted items.
+	 */
+	int itemCount() const;
+
+	/**
+	 \brief Sorts the submitted items.
+	 */
+	void sort();
+
+	/**
+	 \brief Draws the items, in sort order.
+	 */
+	void execute();
+
+	/**
+	 \brief Number of program or mesh changes during the last execution.
+	 */
+	int stateChanges() const;
+
+	/**
+	 \brief Builds the sort key of an item.
+	 \param pass Render pass.
+	 \param program Shader program GL reference.
+	 \param mesh Vertex array object GL reference.
+	 \param depth Item depth.
+	 \param sequence Submission order, only taken into account on the overlay pass.
+	 */
+	static SortKey sortKey(Pass pass, unsigned int program, unsigned int mesh, float depth, unsigned int sequence);
+
+private:
+	struct Entry {
+		SortKey key;
+		int index;
+	};
+
+	std::vector<Item> _items;
+	std::vector<Entry> _order;
+	std::vector<Entry> _scratch;
+	OMatrix4x4 _viewProjection;
+	int _stateChanges;
+
+	/**
+	 \brief Sets up the blending and depth write state of a pass.
+	 */
+	static void setPassState(Pass pass);
+};
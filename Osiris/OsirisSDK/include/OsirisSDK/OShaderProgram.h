@@ -2,6 +2,8 @@
 
 #include <string>
 #include <list>
+#include <vector>
+#include <unordered_map>
 
 #include "GLdefs.h"
 #include "defs.h"
@@ -17,6 +19,11 @@
 
 /**
  \brief Class that represents a shader program.
+
+ Once the program is linked, its active uniforms and attributes are reflected into hashed tables, so that
+ locations are not looked up in the driver by name. Uniforms are also reachable through handles, resolved once by
+ name, that keep a shadow of the last uploaded value: uploading the value that the program already holds is
+ skipped. The camera uniform block (see OCamera) is bound to its binding point as well.
 */
 class OAPI OShaderProgram
 {
@@ -53,8 +60,16 @@ public:
 	void addShader(OShaderObject::ShaderType type, const char* name, int resourceId); 
 #endif
 
+	/**
+	 \brief Uniform handle, or -1 if invalid.
+	 */
+	typedef int UniformHandle;
+
 	/**
 	 \brief Get the shader uniform parameter by name.
+
+	 Active uniforms are found in the reflected table. Other names, such as array elements ("lights[2]") and
+	 struct members, are looked up in the driver once, and cached.
 	 \param uniform_name Name of the uniform parameter.
 	 \return The OpenGL reference to the uniform.
 	 */
@@ -67,6 +82,42 @@ public:
 	 */
 	GLuint attribLocation(const char* attrib_name);
 
+	/**
+	 \brief Resolves a uniform handle by name.
+
+	 Handles may be resolved before the program is compiled: they remain valid and are bound to the uniform
+	 location once the program is linked. Handles of uniforms that are not active in the program are valid, but
+	 setting them has no effect.
+	 \param uniform_name Name of the uniform parameter.
+	 \return The uniform handle.
+	 */
+	UniformHandle uniformHandle(const char* uniform_name);
+
+	/**
+	 \brief Sets an integer (or boolean, or sampler) uniform. The program must be in use.
+	 */
+	void setUniform(UniformHandle handle, GLint value);
+
+	/**
+	 \brief Sets a float uniform. The program must be in use.
+	 */
+	void setUniform(UniformHandle handle, GLfloat value);
+
+	/**
+	 \brief Sets a three-dimensional vector uniform. The program must be in use.
+	 */
+	void setUniform(UniformHandle handle, const OVector3& value);
+
+	/**
+	 \brief Sets a four-dimensional vector uniform. The program must be in use.
+	 */
+	void setUniform(UniformHandle handle, const OVector4& value);
+
+	/**
+	 \brief Sets a 4x4 matrix uniform. The program must be in use.
+	 */
+	void setUniform(UniformHandle handle, const OMatrix4x4& value);
+
 	/**
 	 \brief Compiles shader objects and links the shader program.
 	*/
@@ -78,9 +129,31 @@ public:
 	void use();
 
 private:
+	struct Uniform {
+		GLint location;
+		bool shadowValid;
+		GLfloat shadow[16];
+	};
+
 	std::string _programName;
 	GLuint _program;
 
 	std::list<OShaderObject*> _shaderList;
+
+	std::vector<Uniform> _uniforms;
+	std::unordered_map<std::string, UniformHandle> _uniformHandles;
+	std::unordered_map<std::string, GLint> _attribLocations;
+	bool _linked;
+
+	/**
+	 \brief Reads the active uniforms and attributes of the linked program.
+	 */
+	void reflect();
+
+	/**
+	 \brief Updates the shadow value of a uniform.
+	 \return False if the uniform already holds the value, or if it is not active.
+	 */
+	bool changed(UniformHandle handle, const void* value, size_t size);
 };
 
@@ -1,17 +1,46 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #include "defs.h"
 #include "OApplication.h"
 #include "OCollection.hpp"
+#include "ORenderQueue.h"
+#include "OBoundingVolumeHierarchy.hpp"
 
 class OEntity;
 class ORenderObject;
+class OMesh;
+class OOcclusionCuller;
+
+#ifndef OSIMULATION_OCCLUSIONTEST_CHUNKSIZE
+#define OSIMULATION_OCCLUSIONTEST_CHUNKSIZE	64
+#endif
 
 /**
  @brief An OApplication implementation, designed to ease entity handling and renderization.
 
  This class is an implementation of OApplication that simplifies the general application API, controlling simulation 
  entities and other objects that can be rendered. 
+
+ Rendering goes through a render queue: entities and render objects submit their draw items, which are then sorted
+ to minimize state changes and drawn (see ORenderQueue).
+
+ By default, entities are rendered with instancing: visible entities are grouped by mesh, and each mesh is drawn
+ once for all of its entities, with their model matrices streamed to the shader (see OMesh::renderInstanced()).
+
+ Objects outside of the camera view frustum are not submitted: entities are tested by the bounding sphere of their
+ meshes, and render objects by their own bounds, if they have any. Static entities (see OEntity::isStatic()) are
+ kept in a bounding volume hierarchy, so they are culled a subtree at a time (see OBoundingVolumeHierarchy), while
+ the other entities are tested in batches (see OFrustum). Hidden entities are left out of the hierarchy, which is
+ built again when entities are added, removed, shown or hidden (showing or hiding other render objects leaves it
+ alone): if a static entity is moved, or given a behavior or another mesh, invalidateStaticEntities() must be
+ called.
+
+ Optionally, entities hidden behind others are culled as well: the occluders of the visible entities (see
+ OEntity::setOccluder()) are rasterized on the CPU, and the other visible entities are tested against them (see
+ OOcclusionCuller). Both steps run on the application thread pool.
  */
 class OAPI OSimulation : public OApplication
 {
@@ -49,13 +78,161 @@ public:
 	 */
 	OCollection<ORenderObject>* renderObjects();
 
+	/**
+	 @brief Enables or disables instanced rendering of the entities.
+	 */
+	void setInstancedRendering(bool enabled);
+
+	/**
+	 @brief Returns true if entities are rendered with instancing.
+	 */
+	bool instancedRendering() const;
+
+	/**
+	 @brief Enables or disables view-frustum culling.
+	 */
+	void setFrustumCulling(bool enabled);
+
+	/**
+	 @brief Returns true if objects outside of the view frustum are culled.
+	 */
+	bool frustumCulling() const;
+
+	/**
+	 @brief Enables or disables occlusion culling. Disabled by default.
+	 */
+	void setOcclusionCulling(bool enabled);
+
+	/**
+	 @brief Returns true if entities hidden behind occluders are culled.
+	 */
+	bool occlusionCulling() const;
+
+	/**
+	 @brief Returns the occlusion culler, created when occlusion culling is first enabled (NULL before that).
+	 */
+	OOcclusionCuller* occlusionCuller();
+
+	/**
+	 @brief Tells that static entities changed, so that the bounding volume hierarchy is built again.
+	 */
+	void invalidateStaticEntities();
+
+	/**
+	 @brief Number of static entities, kept in the bounding volume hierarchy.
+	 */
+	int staticEntityCount() const;
+
+	/**
+	 @brief Number of entities and render objects submitted for rendering on the last frame.
+	 */
+	int visibleCount() const;
+
+	/**
+	 @brief Number of entities and render objects culled on the last frame, for being outside of the view frustum.
+	 */
+	int culledCount() const;
+
+	/**
+	 @brief Number of entities culled on the last frame, for being hidden behind occluders.
+	 */
+	int occludedCount() const;
+
+	/**
+	 @brief Fraction of the entities tested against the occluders on the last frame that were culled.
+	 */
+	float occlusionRejectionRate() const;
+
+	/**
+	 @brief Returns the render queue, as left by the last frame.
+	 */
+	const ORenderQueue& renderQueue() const;
+
 protected:
 	virtual void update(const OTimeIndex & timeIndex, int step_us) override;
 	virtual void render() override;
+	virtual void registerMetrics(OMetricsExporter* exporter) override;
+
+	/**
+	 @brief First update phase: the next state of each entity is made equal to the current one.
+	 */
+	void equalizeStates();
+
+	/**
+	 @brief Second update phase: each entity computes its next state.
+	 */
+	void updateStates(const OTimeIndex & timeIndex, int step_us);
+
+	/**
+	 @brief Last update phase: the next state of each entity becomes the current one.
+	 */
+	void swapStates(const OTimeIndex & timeIndex, int step_us);
 
 private:
 	OCollection<OEntity> _entities;
 	OCollection<ORenderObject> _renderObjects;
 
+	struct InstanceBatch {
+		InstanceBatch() : mesh(NULL), first(NULL), count(0) { }
+		OMesh* mesh;
+		OEntity* first;
+		int count;
+		std::vector<float> matrices;
+	};
+
+	ORenderQueue _renderQueue;
+	bool _instancedRendering;
+	/* batches in the order their meshes are first seen, so that submission does not depend on addresses */
+	std::vector<InstanceBatch> _instanceBatches;
+	std::unordered_map<OMesh*, int> _instanceBatchIndex;
+	int _instanceBatchCount;
+
+	bool _frustumCulling;
+	int _visibleCount;
+	int _culledCount;
+	std::vector<OEntity*> _visibleEntities;
+
+	/* static entities, and the ones that must be tested every frame */
+	OBoundingVolumeHierarchy<OEntity> _staticEntities;
+	std::vector<OEntity*> _dynamicEntities;
+	std::vector<OEntity*> _staticVisible;
+	unsigned long long _entitiesRevision;
+	unsigned long long _visibilityRevision;
+	bool _staticEntitiesValid;
+
+	/* culling candidates: dynamic entities with bounds, and their bounding spheres (structure-of-arrays) */
+	std::vector<OEntity*> _cullEntities;
+	std::vector<float> _cullX;
+	std::vector<float> _cullY;
+	std::vector<float> _cullZ;
+	std::vector<float> _cullRadius;
+	std::vector<unsigned char> _cullVisible;
+
+	/* occlusion culling: candidates are the visible entities that are not occluders themselves */
+	OOcclusionCuller* _occlusionCuller;
+	bool _occlusionCulling;
+	int _occludedCount;
+	int _occlusionTested;
+	std::vector<unsigned char> _occluded;
+
+	/**
+	 @brief Builds the list of visible entities, leaving out the ones that are hidden or outside of the view frustum.
+	 */
+	void cullEntities();
+
+	/**
+	 @brief Sorts the entities into static and dynamic, and builds the bounding volume hierarchy.
+	 */
+	void classifyEntities();
+
+	/**
+	 @brief Removes the entities that are hidden behind occluders from the list of visible entities.
+	 */
+	void occlusionCullEntities();
+
+	/**
+	 @brief Submits the visible entities to the render queue, as one item per mesh.
+	 */
+	void submitEntitiesInstanced(OMatrixStack* mtx);
 };
 
@@ -200,6 +200,11 @@ public:
 	 */
 	void disableAllConstraints();
 
+	/**
+	 @brief Returns true if all of the motion components (velocity, acceleration, etc) are zero.
+	 */
+	bool isMotionless() const;
+
 	/**
 	 @brief Update state for a given time index.
 	 @param timeIndex Time index.
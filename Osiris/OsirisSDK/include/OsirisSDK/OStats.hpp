@@ -1,6 +1,6 @@
 #pragma once
 
-#include <queue>
+#include <vector>
 #include <cmath>
 #include "defs.h"
 
@@ -8,8 +8,29 @@
 #define OSTATS_DEFAULT_SAMPLE_SIZE	5
 #endif
 
+#ifndef OSTATS_HISTOGRAM_SUBBUCKETS
+#define OSTATS_HISTOGRAM_SUBBUCKETS	16
+#endif
+
+#ifndef OSTATS_HISTOGRAM_MINEXP
+#define OSTATS_HISTOGRAM_MINEXP		-16
+#endif
+
+#ifndef OSTATS_HISTOGRAM_MAXEXP
+#define OSTATS_HISTOGRAM_MAXEXP		48
+#endif
+
 /**
  @brief Template class to handle statistical data.
+
+ Statistics are computed over a sliding window of the latest samples, kept in a fixed-capacity ring buffer.
+ Along with the window, the class maintains:
+ - the mean and variance, updated incrementally with Welford's method as samples enter and leave the window;
+ - a log-linear histogram of the window, with OSTATS_HISTOGRAM_SUBBUCKETS linear buckets per power of two,
+   from which percentiles are taken with a relative error bounded by the bucket width;
+ - the window minimum and maximum, which are only recomputed when the current extreme leaves the window.
+
+ Adding a sample and computing percentiles take constant time regardless of the window size.
  */
 template <class VType> class OStats
 {
@@ -26,7 +47,7 @@ public:
 	virtual ~OStats();
 
 	/**
-	 @brief Set sample size.
+	 @brief Set sample size. The most recent samples are kept.
 	 */
 	void setSampleSize(int size);
 
@@ -35,34 +56,95 @@ public:
 	 */
 	int sampleSize() const;
 
+	/**
+	 @brief Returns the number of samples currently in the window.
+	 */
+	int count() const;
+
 	/**
 	 @brief Add new entry to the ensamble.
 	 */
 	void add(VType val);
 
+	/**
+	 @brief Removes all the samples.
+	 */
+	void clear();
+
 	/**
 	 @brief Average value.
 	 */
 	float average() const;
 
+	/**
+	 @brief Variance.
+	 */
+	float variance() const;
+
 	/**
 	 @brief Standard deviation.
 	 */
 	float stdev() const;
 
+	/**
+	 @brief Minimum value.
+	 */
+	VType minValue() const;
+
+	/**
+	 @brief Maximum value.
+	 */
+	VType maxValue() const;
+
+	/**
+	 @brief Most recent sample, or zero if there are none.
+	 */
+	VType last() const;
+
+	/**
+	 @brief Percentile value, estimated from the histogram.
+	 @param p Percentile, from 0 to 100.
+	 */
+	VType percentile(float p) const;
+
 private:
+	enum {
+		OctaveCount = OSTATS_HISTOGRAM_MAXEXP - OSTATS_HISTOGRAM_MINEXP,
+		ZeroBucket = OctaveCount * OSTATS_HISTOGRAM_SUBBUCKETS,
+		BucketCount = 2 * ZeroBucket + 1
+	};
+
 	int _sampleSize;
-	std::queue<VType> _samples;
-	VType _sum;
-	VType _sumsq;
+	std::vector<VType> _samples;
+	int _head;
+	int _count;
+	double _mean;
+	double _m2;
+	std::vector<int> _histogram;
+	mutable VType _min;
+	mutable VType _max;
+	mutable bool _extremesValid;
+
+	void insert(VType val);
+	void remove(VType val);
+	void updateExtremes() const;
+	static int bucketIndex(double val);
+	static double bucketValue(int idx);
 };
 
 template<class VType>
 inline OStats<VType>::OStats(int sampleSize) :
-	_sampleSize(sampleSize),
-	_sum(0),
-	_sumsq(0)
+	_sampleSize(0),
+	_head(0),
+	_count(0),
+	_mean(0.0),
+	_m2(0.0),
+	_histogram(BucketCount, 0),
+	_min(0),
+	_max(0),
+	_extremesValid(true)
 {
+	setSampleSize(sampleSize);
 }
 
 template<class VType>
@@ -73,8 +155,21 @@ inline OStats<VType>::~OStats()
 template<class VType>
 inline void OStats<VType>::setSampleSize(int size)
 {
-	while (_samples.size() > size) _samples.pop();
+	if (size < 1) size = 1;
+
+	/* keeping the most recent samples, oldest first */
+	std::vector<VType> kept;
+	for (int i = 0; i < _count; i++) kept.push_back(_samples[(_head + i) % _sampleSize]);
+	while ((int)kept.size() > size) {
+		remove(kept.front());
+		kept.erase(kept.begin());
+	}
+
 	_sampleSize = size;
+	_samples.assign(size, VType(0));
+	_head = 0;
+	_count = (int)kept.size();
+	for (int i = 0; i < _count; i++) _samples[i] = kept[i];
 }
 
 template<class VType>
@@ -83,27 +178,180 @@ inline int OStats<VType>::sampleSize() const
 	return _sampleSize;
 }
 
+template<class VType>
+inline int OStats<VType>::count() const
+{
+	return _count;
+}
+
 template<class VType>
 inline void OStats<VType>::add(VType val)
 {
-	_sum += val;
-	_sumsq += val*val;
-	if (_samples.size() == _sampleSize) {
-		_sum -= _samples.front();
-		_sumsq -= _samples.front()*_samples.front();
-		_samples.pop();
+	if (_count == _sampleSize) {
+		remove(_samples[_head]);
+		_samples[_head] = val;
+		_head = (_head + 1) % _sampleSize;
+	} else {
+		_samples[(_head + _count) % _sampleSize] = val;
 	}
-	_samples.push(val);
+	insert(val);
+}
+
+template<class VType>
+inline void OStats<VType>::clear()
+{
+	_head = 0;
+	_count = 0;
+	_mean = 0.0;
+	_m2 = 0.0;
+	_histogram.assign(BucketCount, 0);
+	_min = _max = VType(0);
+	_extremesValid = true;
 }
 
 template<class VType>
 inline float OStats<VType>::average() const
 {
-	return (float)_sum/_samples.size();
+	return (float)_mean;
+}
+
+template<class VType>
+inline float OStats<VType>::variance() const
+{
+	if (_count == 0) return 0.0f;
+	double var = _m2 / _count;
+	return (var > 0.0) ? (float)var : 0.0f;
 }
 
 template<class VType>
 inline float OStats<VType>::stdev() const
 {
-	return sqrt(abs(_sum*_sum - _sumsq))/_samples.size();
+	return std::sqrt(variance());
+}
+
+template<class VType>
+inline VType OStats<VType>::minValue() const
+{
+	if (!_extremesValid) updateExtremes();
+	return _min;
+}
+
+template<class VType>
+inline VType OStats<VType>::maxValue() const
+{
+	if (!_extremesValid) updateExtremes();
+	return _max;
+}
+
+template<class VType>
+inline VType OStats<VType>::last() const
+{
+	if (_count == 0) return VType(0);
+	return _samples[(_head + _count - 1) % _sampleSize];
+}
+
+template<class VType>
+inline VType OStats<VType>::percentile(float p) const
+{
+	if (_count == 0) return VType(0);
+	if (p <= 0.0f) return minValue();
+	if (p >= 100.0f) return maxValue();
+
+	int rank = (int)std::ceil(p / 100.0f * _count);
+	if (rank < 1) rank = 1;
+
+	int idx = 0;
+	for (int acc = 0; idx < BucketCount; idx++) {
+		acc += _histogram[idx];
+		if (acc >= rank) break;
+	}
+
+	/* bucket estimates are kept within the actual sample range */
+	VType val = (VType)bucketValue(idx);
+	if (val < minValue()) return minValue();
+	if (val > maxValue()) return maxValue();
+	return val;
+}
+
+template<class VType>
+inline void OStats<VType>::insert(VType val)
+{
+	_count++;
+	double delta = val - _mean;
+	_mean += delta / _count;
+	_m2 += delta * (val - _mean);
+
+	_histogram[bucketIndex(val)]++;
+
+	if (_count == 1) {
+		_min = _max = val;
+		_extremesValid = true;
+	} else if (_extremesValid) {
+		if (val < _min) _min = val;
+		if (val > _max) _max = val;
+	}
+}
+
+template<class VType>
+inline void OStats<VType>::remove(VType val)
+{
+	_count--;
+	if (_count == 0) {
+		_mean = 0.0;
+		_m2 = 0.0;
+	} else {
+		double delta = val - _mean;
+		_mean -= delta / _count;
+		_m2 -= delta * (val - _mean);
+	}
+
+	_histogram[bucketIndex(val)]--;
+
+	if (val == _min || val == _max) _extremesValid = false;
+}
+
+template<class VType>
+inline void OStats<VType>::updateExtremes() const
+{
+	if (_count > 0) {
+		_min = _max = _samples[_head];
+		for (int i = 1; i < _count; i++) {
+			VType val = _samples[(_head + i) % _sampleSize];
+			if (val < _min) _min = val;
+			if (val > _max) _max = val;
+		}
+	}
+	_extremesValid = true;
+}
+
+template<class VType>
+inline int OStats<VType>::bucketIndex(double val)
+{
+	/* values beyond the histogram range, infinities and NaNs saturate on the last bucket */
+	int offset = OctaveCount * OSTATS_HISTOGRAM_SUBBUCKETS;
+	double mag = std::fabs(val);
+	if (mag < std::ldexp(1.0, OSTATS_HISTOGRAM_MAXEXP)) {
+		/* val = m * 2^exp, with m in [0.5, 1): the exponent selects the octave and m the linear sub-bucket */
+		int exp;
+		double m = std::frexp(mag, &exp);
+		if (m == 0.0 || exp <= OSTATS_HISTOGRAM_MINEXP) return ZeroBucket;
+		int sub = (int)((m - 0.5) * 2 * OSTATS_HISTOGRAM_SUBBUCKETS);
+		offset = 1 + (exp - OSTATS_HISTOGRAM_MINEXP - 1) * OSTATS_HISTOGRAM_SUBBUCKETS + sub;
+	}
+	return (val < 0) ? ZeroBucket - offset : ZeroBucket + offset;
+}
+
+template<class VType>
+inline double OStats<VType>::bucketValue(int idx)
+{
+	if (idx == ZeroBucket) return 0.0;
+
+	int offset = (idx > ZeroBucket) ? idx - ZeroBucket - 1 : ZeroBucket - idx - 1;
+	int exp = offset / OSTATS_HISTOGRAM_SUBBUCKETS + OSTATS_HISTOGRAM_MINEXP + 1;
+	int sub = offset % OSTATS_HISTOGRAM_SUBBUCKETS;
+
+	/* bucket midpoint */
+	double m = 0.5 + (sub + 0.5) / (2 * OSTATS_HISTOGRAM_SUBBUCKETS);
+	double val = std::ldexp(m, exp);
+	return (idx > ZeroBucket) ? val : -val;
 }
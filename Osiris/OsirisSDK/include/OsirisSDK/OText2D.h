@@ -132,6 +132,16 @@ public:
 	 */
 	void render(OMatrixStack* mtx=NULL);
 
+	/**
+	 \brief Submits the text to a render queue, on the overlay pass.
+	 */
+	void submit(ORenderQueue* queue, OMatrixStack* stack);
+
+	/**
+	 \brief Draws the text, when the render queue is executed.
+	 */
+	void renderItem(const ORenderQueue::Item& item, bool stateBound);
+
 	/* inherited from OOBject */
 	void onScreenResize(const OResizeEvent* evt);
 
@@ -151,10 +161,15 @@ private:
 	static bool _initialized;
 	static OShaderProgram *_shaderProgram;
 	static GLuint _shaderCoordAttr;
-	static GLuint _shaderTexUniform;
-	static GLuint _shaderColorUniform;
-	static GLuint _shaderPosition;
-	static GLuint _shaderScale;
+	static OShaderProgram::UniformHandle _shaderTexUniform;
+	static OShaderProgram::UniformHandle _shaderColorUniform;
+	static OShaderProgram::UniformHandle _shaderPosition;
+	static OShaderProgram::UniformHandle _shaderScale;
+
+	/**
+	 \brief Draws the text, with blending already enabled.
+	 */
+	void renderText();
 
 	/**
 	 \brief Initialize the freetype library for all class objects.
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "defs.h"
+
+/**
+ \brief Fixed-size worker thread pool.
+
+ The pool runs data-parallel loops: the index range is split in chunks that are picked up by the
+ worker threads and by the calling thread itself, which blocks until the whole range is processed.
+ Only one loop may run at a time, and loop bodies must not throw.
+ */
+class OAPI OThreadPool
+{
+public:
+	/**
+	 \brief Loop body, called with the [begin, end) index range of a chunk.
+	 */
+	typedef std::function<void(int begin, int end)> Task;
+
+	/**
+	 \brief Class constructor.
+	 \param threadCount Number of worker threads. If zero, one less than the number of hardware
+			    threads is used, since the calling thread also takes part in the loops.
+	 */
+	OThreadPool(int threadCount=0);
+
+	/**
+	 \brief Class destructor. Stops and joins the worker threads.
+	 */
+	virtual ~OThreadPool();
+
+	/**
+	 \brief Returns the number of worker threads.
+	 */
+	int threadCount() const;
+
+	/**
+	 \brief Runs a loop over [0, count) in parallel chunks.
+	 \param count Number of loop iterations.
+	 \param chunkSize Number of iterations handed to a thread at a time.
+	 \param task Loop body.
+	 */
+	void parallelFor(int count, int chunkSize, const Task& task);
+
+private:
+	std::vector<std::thread> _threads;
+	std::mutex _mutex;
+	std::condition_variable _workCond;
+	std::condition_variable _doneCond;
+	const Task* _task;
+	int _count;
+	int _chunkSize;
+	std::atomic<int> _next;
+	int _activeWorkers;
+	unsigned int _generation;
+	bool _stop;
+
+	void worker();
+	void runChunks();
+};
@@ -4,16 +4,42 @@
 #include "windows.h"
 #endif
 
+#include <atomic>
+
 #include "defs.h"
 
+#if !defined(OTIMEINDEX_NO_TSC) && (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__))
+#	define OTIMEINDEX_TSC
+#	ifdef _MSC_VER
+#		include <intrin.h>
+#	else
+#		include <x86intrin.h>
+#	endif
+#endif
+
+#ifndef OTIMEINDEX_TSC_CALIBRATION_US
+#define OTIMEINDEX_TSC_CALIBRATION_US	10000
+#endif
+
 /**
  @brief Deals with the elapsed simulation time.
+
+ The time index is kept as a single signed 64-bit count of nanoseconds, so arithmetic and comparisons are plain
+ integer operations and the range covers centuries. Operators taking an integer operand interpret it in
+ microseconds. Current time is read from a monotonic clock (CLOCK_MONOTONIC, or the performance counter on
+ Windows), relative to the last call to init(), which OApplication makes when it is created.
+
+ For hot-path timing, ticks() reads a raw counter that is converted to a time index only when needed, with
+ fromTicks() or ticksToNanoseconds(). On x86 processors with an invariant time-stamp counter the counter is the
+ TSC itself, read with rdtsc and calibrated against the monotonic clock over OTIMEINDEX_TSC_CALIBRATION_US
+ microseconds, once, on first use; otherwise ticks are nanoseconds of the monotonic clock (served by the vDSO on Linux). The TSC
+ can be disabled at compile time by defining OTIMEINDEX_NO_TSC.
  */
 class OAPI OTimeIndex
 {
 public:
 	/**
-	 @brief Class constructor.
+	 @brief Class constructor. Initializes the index to zero.
 	 */
 	OTimeIndex();
 
@@ -26,135 +52,136 @@ public:
 
 	/**
 	 @brief Class constructor.
-	 @param timeIndex_ms Time index in microseconds.
+	 @param timeIndex_us Time index in microseconds.
 	 */
 	OTimeIndex(long long timeIndex_us);
 
 	/**
-	 @brief Class destructor.
+	 @brief Creates a time index from a nanosecond count.
+	 @param timeIndex_ns Time index in nanoseconds.
 	 */
-	virtual ~OTimeIndex();
+	static OTimeIndex fromNanoseconds(long long timeIndex_ns);
 
 	/**
 	 @brief Subtraction operator.
 	 */
-	inline OTimeIndex operator-(const OTimeIndex& in) const;
+	OTimeIndex operator-(const OTimeIndex& in) const;
 	
 	/**
 	 @brief Subtraction operator.
 	 @param in Time index in microseconds.
 	 */
-	inline OTimeIndex operator-(int in) const;
+	OTimeIndex operator-(int in) const;
 	
 	/**
 	 @brief Subtraction operator.
 	 */
-	inline OTimeIndex& operator-=(const OTimeIndex& in);
+	OTimeIndex& operator-=(const OTimeIndex& in);
 	
 	/**
 	 @brief Subtraction operator.
 	 @param in Time index in microseconds.
 	 */
-	inline OTimeIndex& operator-=(int in);
+	OTimeIndex& operator-=(int in);
 
 	/**
 	 @brief Addition operator.
 	 */
-	inline OTimeIndex operator+(const OTimeIndex& in) const;
+	OTimeIndex operator+(const OTimeIndex& in) const;
 	
 	/**
 	 @brief Addition operator.
 	 @param in Time index in microseconds.
 	 */
-	inline OTimeIndex operator+(int in) const;
+	OTimeIndex operator+(int in) const;
 
 	/**
 	 @brief Addition operator.
 	 */
-	inline OTimeIndex& operator+=(const OTimeIndex& in);
+	OTimeIndex& operator+=(const OTimeIndex& in);
 	
 	/**
 	 @brief Addition operator.
 	 @param in Time index in microseconds.
 	 */
-	inline OTimeIndex& operator+=(int in);
+	OTimeIndex& operator+=(int in);
 
 	/**
 	 @brief Assignment operator.
 	 @param in Time index in microseconds.
 	 */
-	inline OTimeIndex& operator=(int in);
+	OTimeIndex& operator=(int in);
 
 	/**
 	 @brief Less than comparison operator.
 	 */
-	inline bool operator<(const OTimeIndex& in) const;
+	bool operator<(const OTimeIndex& in) const;
 	
 	/**
 	 @brief Less than comparison operator.
 	 @param in Time index in microseconds.
 	 */
-	inline bool operator<(int in) const;
+	bool operator<(int in) const;
 
 	/**
 	 @brief Greater than comparison operator.
 	 */
-	inline bool operator>(const OTimeIndex& in) const;
+	bool operator>(const OTimeIndex& in) const;
 
 	/**
 	 @brief Greater than comparison operator.
 	 @param in Time index in microseconds.
 	 */
-	inline bool operator>(int in) const;
+	bool operator>(int in) const;
 
 	/**
 	 @brief Less than or equal comparison operator.
 	 */
-	inline bool operator<=(const OTimeIndex& in) const;
+	bool operator<=(const OTimeIndex& in) const;
 
 	/**
 	 @brief Less than or equal comparison operator.
 	 @param in Time index in microseconds.
 	 */
-	inline bool operator<=(int in) const;
+	bool operator<=(int in) const;
 
 	/**
 	 @brief Greater than or equal comparison operator.
 	 */
-	inline bool operator>=(const OTimeIndex& in) const;
+	bool operator>=(const OTimeIndex& in) const;
 
 	/**
 	 @brief Greater than or equal comparison operator.
 	 @param in Time index in microseconds.
 	 */
-	inline bool operator>=(int in) const;
+	bool operator>=(int in) const;
 
 	/**
 	 @brief Equals comparison operator.
 	 */
-	inline bool operator==(const OTimeIndex& in) const;
+	bool operator==(const OTimeIndex& in) const;
 
 	/**
 	 @brief Equal comparison operator.
-	 @brief in Time index in microseconds.
+	 @param in Time index in microseconds.
 	 */
-	inline bool operator==(int in) const;
+	bool operator==(int in) const;
 
 	/**
 	 @brief Not equal comparison operator.
 	 */
-	inline bool operator!=(const OTimeIndex& in) const;
+	bool operator!=(const OTimeIndex& in) const;
 
 	/**
 	 @brief Not equal comparison operator.
-	 @brief in Time index in microseconds.
+	 @param in Time index in microseconds.
 	 */
-	inline bool operator!=(int in) const;
+	bool operator!=(int in) const;
 
 	/**
 	 @brief Set time index component values.
 	 @param sec Time in seconds.
-	 @param usec Additional time in microseconds. 
+	 @param uSec Additional time in microseconds. 
 	 */
 	void setValue(int sec, int uSec);
 
@@ -170,11 +197,24 @@ public:
 
 	/**
 	 @brief Converts the time index to an integer in microseconds.
+	 @note The result only fits an int up to about 35 minutes: meant for intervals. Use toMicroseconds() or
+	       toNanoseconds() for absolute time indexes.
 	 */
 	int toInt() const;
 
 	/**
-	 @brief Class initialization method.
+	 @brief Converts the time index to a 64-bit integer in microseconds.
+	 */
+	long long toMicroseconds() const;
+
+	/**
+	 @brief Converts the time index to a 64-bit integer in nanoseconds.
+	 */
+	long long toNanoseconds() const;
+
+	/**
+	 @brief Class initialization method. Resets the origin of current() to the present moment.
+	 @note Until it is called, the origin is the one of the monotonic clock. OApplication calls it when created.
 	 */
 	static void init();
 
@@ -183,15 +223,240 @@ public:
 	 */
 	static OTimeIndex current();
 
+	/**
+	 @brief Returns the current value of the tick counter.
+	 */
+	static long long ticks();
+
+	/**
+	 @brief Converts a tick counter value to a time index, on the same timeline as current().
+	 @param ticks Value returned by ticks().
+	 */
+	static OTimeIndex fromTicks(long long ticks);
+
+	/**
+	 @brief Converts an interval between two tick counter values to nanoseconds.
+	 @param ticks Tick interval.
+	 */
+	static long long ticksToNanoseconds(long long ticks);
+
+	/**
+	 @brief Returns true if the tick counter is the processor time-stamp counter.
+	 */
+	static bool isTSCClock();
+
 private:
-	unsigned int _sec;
-	unsigned int _usec;
+	long long _ns;
 
-#ifdef WIN32
-	static LARGE_INTEGER _wFrequency;
-	static LARGE_INTEGER _wStartingStamp;
-#else
-	OTimeIndex _uStartingStamp;
-#endif
-	void setTimeFromInteger(long long timeIndex);
+	static long long _startingStamp_ns;
+	static long long _startingTicks;
+	static double _nsPerTick;
+	static bool _tscClock;
+	static std::atomic<bool> _calibrated;
+
+	static long long monotonicNanoseconds();
+	static bool hasInvariantTSC();
+
+	/**
+	 @brief Chooses the tick counter, calibrating the TSC if it is used. Runs only once.
+	 */
+	static void calibrate();
+
+	/**
+	 @brief Calls calibrate() if it has not run yet: a single load once it has.
+	 */
+	static void ensureCalibrated();
 };
+
+inline OTimeIndex::OTimeIndex() :
+	_ns(0)
+{
+}
+
+inline OTimeIndex::OTimeIndex(int sec, int usec) :
+	_ns((long long)sec * 1000000000LL + (long long)usec * 1000LL)
+{
+}
+
+inline OTimeIndex::OTimeIndex(long long timeIndex_us) :
+	_ns(timeIndex_us * 1000LL)
+{
+}
+
+inline OTimeIndex OTimeIndex::fromNanoseconds(long long timeIndex_ns)
+{
+	OTimeIndex res;
+	res._ns = timeIndex_ns;
+	return res;
+}
+
+inline OTimeIndex OTimeIndex::operator-(const OTimeIndex & in) const
+{
+	return fromNanoseconds(_ns - in._ns);
+}
+
+inline OTimeIndex OTimeIndex::operator-(int in) const
+{
+	return fromNanoseconds(_ns - in * 1000LL);
+}
+
+inline OTimeIndex & OTimeIndex::operator-=(const OTimeIndex & in)
+{
+	_ns -= in._ns;
+	return *this;
+}
+
+inline OTimeIndex & OTimeIndex::operator-=(int in)
+{
+	_ns -= in * 1000LL;
+	return *this;
+}
+
+inline OTimeIndex OTimeIndex::operator+(const OTimeIndex & in) const
+{
+	return fromNanoseconds(_ns + in._ns);
+}
+
+inline OTimeIndex OTimeIndex::operator+(int in) const
+{
+	return fromNanoseconds(_ns + in * 1000LL);
+}
+
+inline OTimeIndex & OTimeIndex::operator+=(const OTimeIndex & in)
+{
+	_ns += in._ns;
+	return *this;
+}
+
+inline OTimeIndex & OTimeIndex::operator+=(int in)
+{
+	_ns += in * 1000LL;
+	return *this;
+}
+
+inline OTimeIndex & OTimeIndex::operator=(int in)
+{
+	_ns = in * 1000LL;
+	return *this;
+}
+
+inline bool OTimeIndex::operator<(const OTimeIndex & in) const
+{
+	return _ns < in._ns;
+}
+
+inline bool OTimeIndex::operator<(int in) const
+{
+	return _ns < in * 1000LL;
+}
+
+inline bool OTimeIndex::operator>(const OTimeIndex & in) const
+{
+	return _ns > in._ns;
+}
+
+inline bool OTimeIndex::operator>(int in) const
+{
+	return _ns > in * 1000LL;
+}
+
+inline bool OTimeIndex::operator<=(const OTimeIndex & in) const
+{
+	return _ns <= in._ns;
+}
+
+inline bool OTimeIndex::operator<=(int in) const
+{
+	return _ns <= in * 1000LL;
+}
+
+inline bool OTimeIndex::operator>=(const OTimeIndex & in) const
+{
+	return _ns >= in._ns;
+}
+
+inline bool OTimeIndex::operator>=(int in) const
+{
+	return _ns >= in * 1000LL;
+}
+
+inline bool OTimeIndex::operator==(const OTimeIndex & in) const
+{
+	return _ns == in._ns;
+}
+
+inline bool OTimeIndex::operator==(int in) const
+{
+	return _ns == in * 1000LL;
+}
+
+inline bool OTimeIndex::operator!=(const OTimeIndex & in) const
+{
+	return _ns != in._ns;
+}
+
+inline bool OTimeIndex::operator!=(int in) const
+{
+	return _ns != in * 1000LL;
+}
+
+inline void OTimeIndex::setValue(int sec, int uSec)
+{
+	_ns = (long long)sec * 1000000000LL + (long long)uSec * 1000LL;
+}
+
+inline int OTimeIndex::sec() const
+{
+	return (int)(_ns / 1000000000LL);
+}
+
+inline int OTimeIndex::uSec() const
+{
+	return (int)((_ns / 1000LL) % 1000000LL);
+}
+
+inline int OTimeIndex::toInt() const
+{
+	return (int)(_ns / 1000LL);
+}
+
+inline long long OTimeIndex::toMicroseconds() const
+{
+	return _ns / 1000LL;
+}
+
+inline long long OTimeIndex::toNanoseconds() const
+{
+	return _ns;
+}
+
+inline void OTimeIndex::ensureCalibrated()
+{
+	if (!_calibrated.load(std::memory_order_acquire)) calibrate();
+}
+
+inline long long OTimeIndex::ticks()
+{
+	ensureCalibrated();
+#ifdef OTIMEINDEX_TSC
+	if (_tscClock) return (long long)__rdtsc();
+#endif
+	return monotonicNanoseconds();
+}
+
+inline OTimeIndex OTimeIndex::fromTicks(long long ticks)
+{
+	return fromNanoseconds(ticksToNanoseconds(ticks - _startingTicks));
+}
+
+inline long long OTimeIndex::ticksToNanoseconds(long long ticks)
+{
+	ensureCalibrated();
+	return (_tscClock) ? (long long)(ticks * _nsPerTick) : ticks;
+}
+
+inline bool OTimeIndex::isTSCClock()
+{
+	ensureCalibrated();
+	return _tscClock;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <vector>
+
+#include "defs.h"
+#include "OTimeIndex.h"
+
+class OObject;
+
+#ifndef OTIMERWHEEL_LEVELS
+#define OTIMERWHEEL_LEVELS	4
+#endif
+
+#ifndef OTIMERWHEEL_SLOTBITS
+#define OTIMERWHEEL_SLOTBITS	6
+#endif
+
+/**
+ \brief Hierarchical timer wheel.
+
+ Timers are scheduled at a simulation time index and fire through OObject::processTimer() when the wheel
+ is advanced past it. Time is divided in ticks of a fixed resolution; each wheel level has 2^OTIMERWHEEL_SLOTBITS
+ slots and covers a range of ticks 2^OTIMERWHEEL_SLOTBITS times longer than the level below it. Timers
+ farther away than the last level are parked on it and re-inserted until they come into range.
+
+ Scheduling, cancelling and firing a timer are constant time operations, and the timer storage is reused
+ so the steady state does not allocate memory.
+ */
+class OAPI OTimerWheel
+{
+public:
+	/**
+	 \brief Timer cancellation handle.
+	 */
+	struct OAPI Handle {
+		int index;			/**< Timer storage index. */
+		unsigned int generation;	/**< Timer storage generation, used to detect stale handles. */
+
+		/**
+		 \brief Creates an invalid handle.
+		 */
+		Handle();
+	};
+
+	/**
+	 \brief Class constructor.
+	 \param resolution_us Tick length in microseconds.
+	 */
+	OTimerWheel(int resolution_us);
+
+	/**
+	 \brief Class destructor.
+	 */
+	virtual ~OTimerWheel();
+
+	/**
+	 \brief Returns the tick length in microseconds.
+	 */
+	int resolution() const;
+
+	/**
+	 \brief Sets the time index of the first tick. All timers are discarded.
+	 */
+	void start(const OTimeIndex& timeIndex);
+
+	/**
+	 \brief Schedules a timer.
+	 \param target Object whose processTimer() method will be called.
+	 \param timerId Timer identifier passed on to the target object.
+	 \param timeIndex Time index at which the timer fires. Rounded up to the wheel resolution.
+	 \param period_us Timer period in microseconds for periodic timers, or zero for one-shot timers.
+	 \return Handle that can be used to cancel the timer.
+	 */
+	Handle schedule(OObject* target, int timerId, const OTimeIndex& timeIndex, int period_us=0);
+
+	/**
+	 \brief Cancels a timer.
+	 \return False if the timer had already fired (one-shot timers) or had been cancelled.
+	 */
+	bool cancel(const Handle& handle);
+
+	/**
+	 \brief Cancels all timers of a given object.
+
+	 Unlike the other operations, this one is linear on the number of timers.
+	 */
+	void cancelAll(OObject* target);
+
+	/**
+	 \brief Returns true if the timer is still scheduled.
+	 */
+	bool isActive(const Handle& handle) const;
+
+	/**
+	 \brief Returns the number of scheduled timers.
+	 */
+	int activeCount() const;
+
+	/**
+	 \brief Fires all the timers scheduled up to the given time index.
+	 */
+	void advance(const OTimeIndex& timeIndex);
+
+private:
+	enum {
+		SlotCount = 1 << OTIMERWHEEL_SLOTBITS,
+		SlotMask = SlotCount - 1
+	};
+
+	struct Timer {
+		OObject* target;
+		int timerId;
+		long long expires;
+		long long period;
+		unsigned int generation;
+		int prev;
+		int next;
+		int slot;
+	};
+
+	std::vector<Timer> _timers;
+	int _freeList;
+	int _slots[OTIMERWHEEL_LEVELS * SlotCount];
+	int _resolution_us;
+	long long _origin_us;
+	long long _currentTick;
+	int _activeCount;
+
+	void insert(int idx, long long earliestTick);
+	void unlink(int idx);
+	void release(int idx);
+	void cascade(int level, int slotIdx);
+};
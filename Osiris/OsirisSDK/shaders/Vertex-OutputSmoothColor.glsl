@@ -2,14 +2,23 @@
 
 layout (location = 0) in vec4 position;
 layout (location = 1) in vec4 color;
+layout (location = 2) in mat4 instanceMtx;
 
 smooth out vec4 smoothColor;
 
-uniform mat4 transformMtx;
+layout (std140) uniform OCamera {
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+};
+
+uniform mat4 modelMtx;
+uniform bool instanced;
 
 void main()
 {
-	gl_Position = transformMtx * position;
+	if (instanced) gl_Position = viewProjection * modelMtx * instanceMtx * position;
+	else gl_Position = viewProjection * modelMtx * position;
 	smoothColor = color;
 }
 
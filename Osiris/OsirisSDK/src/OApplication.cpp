@@ -1,10 +1,11 @@
-#include <chrono>
-#include <thread>
+#include <algorithm>
 
 #include "OsirisSDK/GLdefs.h"
 #include "OsirisSDK/OException.h"
 #include "OsirisSDK/OApplication.h"
 #include "OsirisSDK/OChronometer.h"
+#include "OsirisSDK/OGPUTimer.h"
+#include "OsirisSDK/OGLState.h"
 
 #include <glload/gl_load.hpp>
 
@@ -18,11 +19,29 @@ OApplication* OApplication::_activeInstance = NULL;
 
 OApplication::OApplication(const char* title, int argc, char **argv, int windowPos_x, int windowPos_y, 
 			   int windowWidth, int windowHeight, int targetFPS, int simulationStep_us) :
-	_targetFPS(targetFPS),
+	_parallelEventDispatch(false),
+	_threadPool(NULL),
+	_eventQueue(OAPPLICATION_DEFAULT_EVENTQUEUE_CAPACITY),
+	_rawEventCount(0),
+	_deliveredEventCount(0),
+	_lastMouseX(-1),
+	_lastMouseY(-1),
+	_framePacer(targetFPS, OAPPLICATION_DEFAULT_STATSSAMPLE),
 	_simulationStep_us(simulationStep_us),
 	_fpsStats(OAPPLICATION_DEFAULT_STATSSAMPLE),
 	_idleTimeStats(OAPPLICATION_DEFAULT_STATSSAMPLE),
-	_renderTimeStats(OAPPLICATION_DEFAULT_STATSSAMPLE)
+	_renderTimeStats(OAPPLICATION_DEFAULT_STATSSAMPLE),
+	_simulationTimeStats(OAPPLICATION_DEFAULT_STATSSAMPLE),
+	_simulationPerformanceStats(OAPPLICATION_DEFAULT_STATSSAMPLE),
+	_inputDispatchLatencyStats(OAPPLICATION_DEFAULT_STATSSAMPLE),
+	_inputPresentLatencyStats(OAPPLICATION_DEFAULT_STATSSAMPLE),
+	_timerWheel(OAPPLICATION_DEFAULT_TIMERRESOLUTION),
+	_fixedTimestep(false),
+	_inputRecorder(NULL),
+	_inputReplay(NULL),
+	_replayDroppedEventCount(0),
+	_metricsExporter(NULL),
+	_profilerExportKey(-1)
 {
 	if (_activeInstance != NULL) throw OException("There is already an OApplication instance created.");
 	_activeInstance = this;
@@ -54,21 +73,34 @@ OApplication::OApplication(const char* title, int argc, char **argv, int windowP
 	glutPassiveMotionFunc(mousePassiveMoveCallback);
 	glutReshapeFunc(resizeCallback);
 
+	/* event coalescing */
+	_eventBatch.reserve(_eventQueue.capacity());
+	for (int i = 0; i < OEvent::EventTypeCount; i++) _eventCoalescing[i] = NoCoalescing;
+	_eventCoalescing[OEvent::typeIndex(OEvent::MouseActiveMoveEvent)] = AccumulateDeltas;
+	_eventCoalescing[OEvent::typeIndex(OEvent::MousePassiveMoveEvent)] = AccumulateDeltas;
+	_eventCoalescing[OEvent::typeIndex(OEvent::ResizeEvent)] = KeepLatest;
+
 	/* z-buffer */
-	glEnable(GL_DEPTH_TEST);
-	glDepthMask(GL_TRUE);
-	glDepthFunc(GL_LEQUAL);
+	OGLState::enable(GL_DEPTH_TEST);
+	OGLState::depthMask(GL_TRUE);
+	OGLState::depthFunc(GL_LEQUAL);
 	glDepthRange(0.0f, 1.0f);
-	glEnable(GL_DEPTH_CLAMP);
+	OGLState::enable(GL_DEPTH_CLAMP);
 
 	/* initializing simulation time frame */
 	OTimeIndex::init();
 	_simulationTimeIndex = OTimeIndex::current();
+	_timerWheel.start(_simulationTimeIndex);
 	_lastRenderTimeIndex = 0;
 }
 
 OApplication::~OApplication()
 {
+	if (_threadPool != NULL) delete _threadPool;
+	stopInputRecording();
+	stopInputReplay();
+	stopMetricsExport();
+	OGPUTimer::release();
 	_activeInstance = NULL;
 }
 
@@ -89,7 +121,7 @@ int OApplication::windowHeight() const
 
 int OApplication::targetFPS() const
 {
-	return _targetFPS;
+	return _framePacer.targetFPS();
 }
 
 int OApplication::simulationStep() const
@@ -99,7 +131,7 @@ int OApplication::simulationStep() const
 
 void OApplication::setTargetFPS(int targetFPS)
 {
-	_targetFPS = targetFPS;
+	_framePacer.setTargetFPS(targetFPS);
 }
 
 void OApplication::setSimulationStep(int simulationStep)
@@ -107,21 +139,157 @@ void OApplication::setSimulationStep(int simulationStep)
 	_simulationStep_us = simulationStep;
 }
 
+void OApplication::setFixedTimestep(bool enabled)
+{
+	_fixedTimestep = enabled;
+}
+
+bool OApplication::fixedTimestep() const
+{
+	return _fixedTimestep;
+}
+
+void OApplication::startInputRecording(const char * filename)
+{
+	stopInputRecording();
+	_inputRecorder = new OInputRecorder(filename, _simulationTimeIndex);
+}
+
+void OApplication::stopInputRecording()
+{
+	if (_inputRecorder == NULL) return;
+	delete _inputRecorder;
+	_inputRecorder = NULL;
+}
+
+void OApplication::startInputReplay(const char * filename)
+{
+	stopInputReplay();
+	_inputReplay = new OInputReplay(filename, _simulationTimeIndex);
+	_replayDroppedEventCount = 0;
+}
+
+void OApplication::stopInputReplay()
+{
+	if (_inputReplay == NULL) return;
+	_replayDroppedEventCount += _inputReplay->droppedCount();
+	delete _inputReplay;
+	_inputReplay = NULL;
+}
+
+bool OApplication::isReplayingInput() const
+{
+	return (_inputReplay != NULL);
+}
+
+int OApplication::replayDroppedEventCount() const
+{
+	return _replayDroppedEventCount + ((_inputReplay != NULL) ? _inputReplay->droppedCount() : 0);
+}
+
+OMetricsExporter * OApplication::startMetricsExport(const char * filename, int interval_us)
+{
+	stopMetricsExport();
+	_metricsExporter = new OMetricsExporter(filename, interval_us);
+	registerMetrics(_metricsExporter);
+	return _metricsExporter;
+}
+
+void OApplication::stopMetricsExport()
+{
+	if (_metricsExporter == NULL) return;
+	delete _metricsExporter;
+	_metricsExporter = NULL;
+}
+
+OMetricsExporter * OApplication::metricsExporter()
+{
+	return _metricsExporter;
+}
+
+void OApplication::setProfilerExportKey(OKeyboardPressEvent::KeyCode key, const char * filename)
+{
+	_profilerExportKey = key;
+	_profilerExportFile = filename;
+}
+
 void OApplication::addEventRecipient(OEvent::EventType eventType, OObject * recipient)
 {
-	bool exists = false;
-	for (list<OObject*>::iterator it = _eventRecipients[eventType].begin(); it != _eventRecipients[eventType].end(); it++) {
-		if (*it == recipient) {
-			exists = true;
-			break;
-		}
-	}
-	if (!exists) _eventRecipients[eventType].push_back(recipient);
+	int idx = OEvent::typeIndex(eventType);
+	vector<OObject*>& recipients = (recipient->isEventThreadSafe()) ? _parallelEventRecipients[idx] : _eventRecipients[idx];
+	if (find(recipients.begin(), recipients.end(), recipient) == recipients.end()) recipients.push_back(recipient);
 }
 
 void OApplication::removeEventRecipient(OEvent::EventType eventType, OObject * recipient)
 {
-	_eventRecipients[eventType].remove(recipient);
+	/* removed from both lists: isEventThreadSafe() may answer differently now, or not at all from a destructor */
+	int idx = OEvent::typeIndex(eventType);
+	vector<OObject*>& serial = _eventRecipients[idx];
+	vector<OObject*>& parallel = _parallelEventRecipients[idx];
+	serial.erase(remove(serial.begin(), serial.end(), recipient), serial.end());
+	parallel.erase(remove(parallel.begin(), parallel.end(), recipient), parallel.end());
+}
+
+bool OApplication::queueEvent(const OEventQueue::Record & evt)
+{
+	return _eventQueue.push(evt);
+}
+
+unsigned int OApplication::droppedEventCount() const
+{
+	return _eventQueue.droppedCount();
+}
+
+void OApplication::setEventCoalescing(OEvent::EventType eventType, EventCoalescing policy)
+{
+	_eventCoalescing[OEvent::typeIndex(eventType)] = policy;
+}
+
+OApplication::EventCoalescing OApplication::eventCoalescing(OEvent::EventType eventType) const
+{
+	return _eventCoalescing[OEvent::typeIndex(eventType)];
+}
+
+int OApplication::rawEventCount() const
+{
+	return _rawEventCount;
+}
+
+int OApplication::deliveredEventCount() const
+{
+	return _deliveredEventCount;
+}
+
+void OApplication::setParallelEventDispatch(bool enabled)
+{
+	_parallelEventDispatch = enabled;
+	if (enabled) threadPool();
+}
+
+bool OApplication::parallelEventDispatch() const
+{
+	return _parallelEventDispatch;
+}
+
+OThreadPool * OApplication::threadPool()
+{
+	if (_threadPool == NULL) _threadPool = new OThreadPool();
+	return _threadPool;
+}
+
+const OTimeIndex & OApplication::simulationTimeIndex() const
+{
+	return _simulationTimeIndex;
+}
+
+OTimerWheel::Handle OApplication::scheduleTimer(OObject * target, int timerId, const OTimeIndex & timeIndex, int period_us)
+{
+	return _timerWheel.schedule(target, timerId, timeIndex, period_us);
+}
+
+bool OApplication::cancelTimer(const OTimerWheel::Handle & handle)
+{
+	return _timerWheel.cancel(handle);
 }
 
 void OApplication::start()
@@ -146,16 +314,36 @@ const OStats<int>& OApplication::idleTimeStats() const
 	return _idleTimeStats;
 }
 
+const OFramePacer & OApplication::framePacer() const
+{
+	return _framePacer;
+}
+
 const OStats<int>& OApplication::renderTimeStats() const
 {
 	return _renderTimeStats;
 }
 
+const OStats<int>& OApplication::simulationTimeStats() const
+{
+	return _simulationTimeStats;
+}
+
 const OStats<float>& OApplication::performanceStats() const
 {
 	return _simulationPerformanceStats;
 }
 
+const OStats<int>& OApplication::inputDispatchLatencyStats() const
+{
+	return _inputDispatchLatencyStats;
+}
+
+const OStats<int>& OApplication::inputPresentLatencyStats() const
+{
+	return _inputPresentLatencyStats;
+}
+
 OApplication * OApplication::activeInstance()
 {
 	return _activeInstance;
@@ -170,33 +358,143 @@ void OApplication::clearScreen()
 
 int OApplication::eventRecipientCount(OEvent::EventType type)
 {
-	map<OEvent::EventType, list<OObject*> >::iterator it = _eventRecipients.find(type);
-	if (it == _eventRecipients.end()) return 0;
-	return it->second.size();
+	int idx = OEvent::typeIndex(type);
+	return (int)(_eventRecipients[idx].size() + _parallelEventRecipients[idx].size());
 }
 
-void OApplication::queueEvent(OEvent * evt)
+void OApplication::processEvents()
 {
-	_eventQueue.push(evt);
+	OPROFILE_ZONE("OApplication::processEvents");
+
+	/* collecting the queued events, coalescing consecutive events of the same type. The number of
+	   events taken is bounded by the queue capacity so that producers can't stall the frame. */
+	OEventQueue::Record rec;
+	_eventBatch.clear();
+	_rawEventCount = 0;
+	if (_inputReplay != NULL) {
+		_inputReplay->inject(this, _simulationTimeIndex);
+		/* live input is taken again once the recorded events run out */
+		if (_inputReplay->finished()) stopInputReplay();
+	}
+	while (_rawEventCount < _eventQueue.capacity() && _eventQueue.pop(&rec)) {
+		_rawEventCount++;
+		if (_inputRecorder != NULL) _inputRecorder->record(_simulationTimeIndex, rec);
+		if (_eventBatch.empty() == false && _eventBatch.back().type == rec.type) {
+			OEventQueue::Record& last = _eventBatch.back();
+			EventCoalescing policy = _eventCoalescing[OEvent::typeIndex(rec.type)];
+			if (policy == AccumulateDeltas &&
+			    (rec.type == OEvent::MouseActiveMoveEvent || rec.type == OEvent::MousePassiveMoveEvent)) {
+				rec.data.mouseMove.dx += last.data.mouseMove.dx;
+				rec.data.mouseMove.dy += last.data.mouseMove.dy;
+			}
+			if (policy != NoCoalescing) {
+				/* the merged event keeps the oldest time stamp, so latency is not underestimated */
+				long long timestamp_us = last.timestamp_us;
+				last = rec;
+				last.timestamp_us = timestamp_us;
+				continue;
+			}
+		}
+		_eventBatch.push_back(rec);
+	}
+
+	/* delivering */
+	_deliveredEventCount = (int)_eventBatch.size();
+	for (size_t i = 0; i < _eventBatch.size(); i++) {
+		dispatchEvent(_eventBatch[i]);
+		_inputDispatchLatencyStats.add((int)(OTimeIndex::current().toMicroseconds() - _eventBatch[i].timestamp_us));
+	}
 }
 
-void OApplication::processEvents()
+void OApplication::dispatchEvent(const OEventQueue::Record & rec)
 {
-	while (_eventQueue.empty() == false) {
-		OEvent *cur = _eventQueue.front();
-		list<OObject*>::iterator it;
-		for (it = _eventRecipients[cur->type()].begin(); it != _eventRecipients[cur->type()].end(); it++) {
-			(*it)->processEvent(cur);
+	switch (rec.type) {
+	case OEvent::KeyboardPressEvent:
+	case OEvent::KeyboardReleaseEvent:
+		{
+			OKeyboardPressEvent evt((OKeyboardPressEvent::KeyCode)rec.data.keyboard.code,
+						rec.data.keyboard.mouse_x, rec.data.keyboard.mouse_y,
+						(rec.type == OEvent::KeyboardPressEvent));
+			evt.setTimestamp(rec.timestamp_us);
+			dispatchEvent(&evt);
 		}
-		delete cur;
-		_eventQueue.pop();
+		break;
+	case OEvent::MouseClickEvent:
+		{
+			OMouseClickEvent evt((OMouseClickEvent::MouseButton)rec.data.mouseClick.button,
+					     (OMouseClickEvent::MouseStatus)rec.data.mouseClick.status,
+					     rec.data.mouseClick.x, rec.data.mouseClick.y);
+			evt.setTimestamp(rec.timestamp_us);
+			dispatchEvent(&evt);
+		}
+		break;
+	case OEvent::MouseActiveMoveEvent:
+	case OEvent::MousePassiveMoveEvent:
+		{
+			OMouseMoveEvent evt((rec.type == OEvent::MouseActiveMoveEvent) ?
+						OMouseMoveEvent::ActiveMove : OMouseMoveEvent::PassiveMove,
+					    rec.data.mouseMove.x, rec.data.mouseMove.y,
+					    rec.data.mouseMove.dx, rec.data.mouseMove.dy);
+			evt.setTimestamp(rec.timestamp_us);
+			dispatchEvent(&evt);
+		}
+		break;
+	case OEvent::ResizeEvent:
+		{
+			OResizeEvent evt(rec.data.resize.width, rec.data.resize.height);
+			evt.setTimestamp(rec.timestamp_us);
+			dispatchEvent(&evt);
+		}
+		break;
 	}
 }
 
+void OApplication::dispatchEvent(OEvent * evt)
+{
+	int idx = OEvent::typeIndex(evt->type());
+
+	/* order-dependent recipients */
+	vector<OObject*>& recipients = _eventRecipients[idx];
+	for (size_t i = 0; i < recipients.size(); i++) recipients[i]->processEvent(evt);
+
+	/* thread-safe recipients */
+	vector<OObject*>& parallelRecipients = _parallelEventRecipients[idx];
+	if (_parallelEventDispatch && parallelRecipients.size() >= OAPPLICATION_PARALLELDISPATCH_MINRECIPIENTS) {
+		_threadPool->parallelFor((int)parallelRecipients.size(), OAPPLICATION_PARALLELDISPATCH_CHUNKSIZE,
+					 [&parallelRecipients, evt](int begin, int end) {
+			for (int i = begin; i < end; i++) parallelRecipients[i]->processEvent(evt);
+		});
+	} else {
+		for (size_t i = 0; i < parallelRecipients.size(); i++) parallelRecipients[i]->processEvent(evt);
+	}
+}
+
+void OApplication::registerMetrics(OMetricsExporter * exporter)
+{
+	exporter->addMetric("fps", &_fpsStats);
+	exporter->addMetric("frameTime_us", &_framePacer.frameTimeStats());
+	exporter->addMetric("frameJitter_us", &_framePacer.jitterStats());
+	exporter->addMetric("idleTime_us", &_idleTimeStats);
+	exporter->addMetric("renderTime_us", &_renderTimeStats);
+	exporter->addMetric("simulationTime_us", &_simulationTimeStats);
+	exporter->addMetric("performance", &_simulationPerformanceStats);
+	exporter->addMetric("inputDispatchLatency_us", &_inputDispatchLatencyStats);
+	exporter->addMetric("inputPresentLatency_us", &_inputPresentLatencyStats);
+	exporter->addMetric("deliveredEvents", [this]() { return (double)_deliveredEventCount; });
+	exporter->addMetric("droppedEvents", [this]() { return (double)droppedEventCount(); });
+	exporter->addMetric("replayDroppedEvents", [this]() { return (double)replayDroppedEventCount(); });
+	exporter->addMetric("glStateCallsIssued", []() { return (double)OGLState::frameIssued(); });
+	exporter->addMetric("glStateCallsSkipped", []() { return (double)OGLState::frameSkipped(); });
+	exporter->addMetric("memory_bytes", []() { return (double)OMetricsExporter::processMemory(); });
+}
+
 void OApplication::deleteObjects()
 {
 	map<OObject*, int>::iterator it;
-	for (it = _deleteList.begin(); it != _deleteList.end(); it++) delete it->first;
+	for (it = _deleteList.begin(); it != _deleteList.end(); it++) {
+		_timerWheel.cancelAll(it->first);
+		delete it->first;
+	}
 	_deleteList.clear();
 }
 
@@ -211,27 +509,22 @@ void OApplication::loopIteration()
 	/* running the simulation */
 	cron.partial();
 	int stepCount = 0;
-	while ((cron.lastPartialTime() - _simulationTimeIndex).toInt() > _simulationStep_us) {
+	while ((_fixedTimestep) ? (stepCount == 0) :
+				  ((cron.lastPartialTime() - _simulationTimeIndex).toInt() > _simulationStep_us)) {
+		OPROFILE_ZONE("OApplication::simulationStep");
 		_simulationTimeIndex += _simulationStep_us;
+		_timerWheel.advance(_simulationTimeIndex);
 		update(_simulationTimeIndex, _simulationStep_us);
 		stepCount++;
 	}
 
 	/* calculate mean performance indicator */
-	if (stepCount > 0) _simulationPerformanceStats.add((float)cron.partial() / stepCount / _simulationStep_us);
+	int simulationTime_us = cron.partial();
+	_simulationTimeStats.add(simulationTime_us);
+	if (stepCount > 0) _simulationPerformanceStats.add((float)simulationTime_us / stepCount / _simulationStep_us);
 
 	/* limit rendering frequency */
-	cron.partial();
-	if (_targetFPS > 0) {
-		int renderInterval_us = (cron.lastPartialTime() - _lastRenderTimeIndex).toInt();
-		int frameInterval_us = 1000000 / _targetFPS;
-		if (renderInterval_us < frameInterval_us && _lastRenderTimeIndex > 0) {
-			this_thread::sleep_for(chrono::microseconds(frameInterval_us - renderInterval_us));
-		}
-		_idleTimeStats.add(frameInterval_us - renderInterval_us);
-	} else {
-		_idleTimeStats.add(0);
-	}
+	_idleTimeStats.add(_framePacer.wait());
 
 	/* calculate FPS and render */
 	cron.partial();
@@ -239,65 +532,95 @@ void OApplication::loopIteration()
 	_lastRenderTimeIndex = cron.lastPartialTime();
 
 	render();
-	glutSwapBuffers();
+	{
+		OPROFILE_ZONE("OApplication::swapBuffers");
+		glutSwapBuffers();
+	}
+	OGPUTimer::newFrame();
+	OGLCounters::newFrame();
+	OGLState::newFrame();
 	glutPostRedisplay();
+
+	/* input latency up to the buffer swap, for the events delivered on this iteration */
+	long long swapTime_us = OTimeIndex::current().toMicroseconds();
+	for (size_t i = 0; i < _eventBatch.size(); i++) {
+		_inputPresentLatencyStats.add((int)(swapTime_us - _eventBatch[i].timestamp_us));
+	}
 	
 	_renderTimeStats.add(cron.partial());
 
 	/* delete objects at the end of the iteration */
 	deleteObjects();
+
+	/* metrics export */
+	if (_metricsExporter != NULL) _metricsExporter->update();
 }
 
 void OApplication::keyboardCallback(unsigned char key, int mouse_x, int mouse_y)
 {
+#ifdef OSIRIS_PROFILER
+	/* without the profiler there is nothing to export, so the key goes to the application as usual */
+	if (key == _activeInstance->_profilerExportKey) {
+		OProfiler::exportChromeTrace(_activeInstance->_profilerExportFile.c_str());
+		return;
+	}
+#endif
+	if (_activeInstance->isReplayingInput()) return;
 	if (_activeInstance->eventRecipientCount(OEvent::KeyboardPressEvent)) {
-		OKeyboardPressEvent *evt = new OKeyboardPressEvent((OKeyboardPressEvent::KeyCode)key, mouse_x, mouse_y, true);
-		_activeInstance->queueEvent(evt);
+		_activeInstance->queueEvent(OEventQueue::Record::keyboard((OKeyboardPressEvent::KeyCode)key, mouse_x, mouse_y, true));
 	}
 }
 
 void OApplication::keyboardUpCallback(unsigned char key, int mouse_x, int mouse_y)
 {
+	if (_activeInstance->isReplayingInput()) return;
 	if (_activeInstance->eventRecipientCount(OEvent::KeyboardReleaseEvent)) {
-		OKeyboardPressEvent *evt = new OKeyboardPressEvent((OKeyboardPressEvent::KeyCode)key, mouse_x, mouse_y, false);
-		_activeInstance->queueEvent(evt);
+		_activeInstance->queueEvent(OEventQueue::Record::keyboard((OKeyboardPressEvent::KeyCode)key, mouse_x, mouse_y, false));
 	}
 }
 
 void OApplication::mouseCallback(int button, int state, int x, int y)
 {
+	if (_activeInstance->isReplayingInput()) return;
 	if (_activeInstance->eventRecipientCount(OEvent::MouseClickEvent) > 0) {
-		OMouseClickEvent *evt = new OMouseClickEvent((OMouseClickEvent::MouseButton)button,
-						   (OMouseClickEvent::MouseStatus)state,
-						   x, y);
-		_activeInstance->queueEvent(evt);
+		_activeInstance->queueEvent(OEventQueue::Record::mouseClick((OMouseClickEvent::MouseButton)button,
+									   (OMouseClickEvent::MouseStatus)state,
+									   x, y));
 	}
 }
 
 void OApplication::mouseActiveMoveCallback(int x, int y)
 {
+	int dx = (_activeInstance->_lastMouseX >= 0) ? x - _activeInstance->_lastMouseX : 0;
+	int dy = (_activeInstance->_lastMouseY >= 0) ? y - _activeInstance->_lastMouseY : 0;
+	_activeInstance->_lastMouseX = x;
+	_activeInstance->_lastMouseY = y;
+
+	if (_activeInstance->isReplayingInput()) return;
 	if (_activeInstance->eventRecipientCount(OEvent::MouseActiveMoveEvent) > 0) {
-		OMouseMoveEvent *evt = new OMouseMoveEvent(OMouseMoveEvent::ActiveMove, x, y);
-		_activeInstance->queueEvent(evt);
+		_activeInstance->queueEvent(OEventQueue::Record::mouseMove(OMouseMoveEvent::ActiveMove, x, y, dx, dy));
 	}
 }
 
 void OApplication::mousePassiveMoveCallback(int x, int y)
 {
+	int dx = (_activeInstance->_lastMouseX >= 0) ? x - _activeInstance->_lastMouseX : 0;
+	int dy = (_activeInstance->_lastMouseY >= 0) ? y - _activeInstance->_lastMouseY : 0;
+	_activeInstance->_lastMouseX = x;
+	_activeInstance->_lastMouseY = y;
+
+	if (_activeInstance->isReplayingInput()) return;
 	if (_activeInstance->eventRecipientCount(OEvent::MousePassiveMoveEvent) > 0) {
-		OMouseMoveEvent *evt = new OMouseMoveEvent(OMouseMoveEvent::PassiveMove, x, y);
-		_activeInstance->queueEvent(evt);
+		_activeInstance->queueEvent(OEventQueue::Record::mouseMove(OMouseMoveEvent::PassiveMove, x, y, dx, dy));
 	}
 }
 
 void OApplication::resizeCallback(int width, int height)
 {
 	if (_activeInstance->eventRecipientCount(OEvent::ResizeEvent) > 0) {
-		OResizeEvent *evt = new OResizeEvent(width, height);
-
 		glViewport(0, 0, (GLsizei)width, (GLsizei)height);
 		_activeInstance->camera()->setAspectRatio((float)width / height);
-		_activeInstance->queueEvent(evt);
+		_activeInstance->queueEvent(OEventQueue::Record::resize(width, height));
 	}
 }
 
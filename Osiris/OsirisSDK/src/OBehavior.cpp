@@ -14,6 +14,11 @@ void OBehavior::processEvent(OParameterList ** attribute, ODoubleBuffer<OState>*
 	}
 }
 
+void OBehavior::onTimer(OParameterList **, ODoubleBuffer<OState>*, int, const OTimeIndex &)
+{
+	/* by default do nothing */
+}
+
 void OBehavior::onKeyboardPress(OParameterList ** attribute, ODoubleBuffer<OState>* state, const OKeyboardPressEvent * evt)
 {
 	/* by default do nothing */
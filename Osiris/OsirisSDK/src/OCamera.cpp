@@ -1,3 +1,6 @@
+#include <string.h>
+
+#include "OsirisSDK/OGLState.h"
 #include "OsirisSDK/OCamera.h"
 
 OCamera::OCamera(float fieldOfViewDeg, float aspectRatio, float zNear, float zFar, const OVector3 & pos, const OVector3 & dir) :
@@ -6,12 +9,15 @@ OCamera::OCamera(float fieldOfViewDeg, float aspectRatio, float zNear, float zFa
 	_aspectRatio(aspectRatio),
 	_zNear(zNear),
 	_zFar(zFar),
-	_state(OState::Object)
+	_state(OState::Object),
+	_uniformBuffer(0),
+	_uniformBufferValid(false)
 {
 }
 
 OCamera::~OCamera()
 {
+	if (_uniformBuffer != 0) OGLState::deleteBuffers(1, &_uniformBuffer);
 }
 
 void OCamera::setFieldOfView(float valueDeg)
@@ -93,8 +99,65 @@ const OMatrixStack* OCamera::transform()
 	}
 
 	if (popCameraTransform) _transform.pop();
+	OMatrix4x4 projection = _transform.top();
 	_transform.push();
-	_transform.camera(state()->position(), state()->position() + state()->orientation()*OVector3(0.0f, 0.0f, -1.0f));
+
+	OMatrixStack view;
+	OVector3 position = state()->position();
+	OVector3 target = position + state()->orientation()*OVector3(0.0f, 0.0f, -1.0f);
+	view.camera(position, target);
+	_transform *= view.top(); /* projection * view */
+
+	updateUniformBuffer(view.top(), projection);
 	return &_transform;
 }
 
+const OFrustum& OCamera::frustum() const
+{
+	return _frustum;
+}
+
+const OMatrix4x4& OCamera::viewMatrix() const
+{
+	return _matrices[0];
+}
+
+const OMatrix4x4& OCamera::projectionMatrix() const
+{
+	return _matrices[1];
+}
+
+const OMatrix4x4& OCamera::viewProjectionMatrix() const
+{
+	return _matrices[2];
+}
+
+void OCamera::updateUniformBuffer(const OMatrix4x4& view, const OMatrix4x4& projection)
+{
+	OMatrix4x4 matrices[3] = { view, projection, _transform.top() };
+
+	/* std140 layout: three column-major mat4, 64 bytes each */
+	static const size_t mtxSize = 16 * sizeof(GLfloat);
+	if (_uniformBuffer == 0) {
+		glGenBuffers(1, &_uniformBuffer);
+		OGLState::bindBuffer(GL_UNIFORM_BUFFER, _uniformBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, 3 * mtxSize, NULL, GL_DYNAMIC_DRAW);
+	}
+
+	/* the binding point is shared: the camera that was updated last is the one used for rendering */
+	OGLState::bindBufferBase(GL_UNIFORM_BUFFER, OCAMERA_UNIFORMBLOCK_BINDING, _uniformBuffer);
+
+	bool changed = !_uniformBufferValid;
+	for (int i = 0; i < 3; i++) {
+		if (memcmp(_matrices[i].glArea(), matrices[i].glArea(), mtxSize) != 0) changed = true;
+		_matrices[i] = matrices[i];
+	}
+	if (!changed) return;
+
+	_frustum.setMatrix(_matrices[2]);
+
+	OGLState::bindBuffer(GL_UNIFORM_BUFFER, _uniformBuffer);
+	for (int i = 0; i < 3; i++) glBufferSubData(GL_UNIFORM_BUFFER, i * mtxSize, mtxSize, _matrices[i].glArea());
+	_uniformBufferValid = true;
+}
+
@@ -12,30 +12,28 @@ OChronometer::~OChronometer()
 
 void OChronometer::reset()
 {
-	_start = _last = OTimeIndex::current();
+	_start = _last = OTimeIndex::ticks();
 }
 
 int OChronometer::partial()
 {
-	int ret;
-	OTimeIndex curr = OTimeIndex::current();
-	ret = (curr - _last).toInt();
+	long long curr = OTimeIndex::ticks();
+	int ret = (int)(OTimeIndex::ticksToNanoseconds(curr - _last) / 1000);
 	_last = curr;
 	return ret;
 }
 
 int OChronometer::totalElapsed() const
 {
-	OTimeIndex curr = OTimeIndex::current();
-	return (curr - _start).toInt();
+	return (int)(OTimeIndex::ticksToNanoseconds(OTimeIndex::ticks() - _start) / 1000);
 }
 
 OTimeIndex OChronometer::startTime() const
 {
-	return _start;
+	return OTimeIndex::fromTicks(_start);
 }
 
 OTimeIndex OChronometer::lastPartialTime() const
 {
-	return _last;
+	return OTimeIndex::fromTicks(_last);
 }
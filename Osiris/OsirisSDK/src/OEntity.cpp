@@ -1,3 +1,5 @@
+#include <math.h>
+
 #include "OsirisSDK/OMatrixStack.h"
 #include "OsirisSDK/OMesh.h"
 #include "OsirisSDK/OBehavior.h"
@@ -6,10 +8,13 @@
 
 using namespace std;
 
+std::atomic<unsigned long long> OEntity::_visibilityRevision(0);
+
 OEntity::OEntity(OParameterList * attributes, OBehavior* behavior, OMesh * mesh) :
 	_attributes(attributes),
 	_behavior(behavior),
 	_mesh(mesh),
+	_occluder(NULL),
 	_disabled(false)
 { }
 
@@ -23,6 +28,17 @@ void OEntity::processEvent(const OEvent * evt)
 	if (_behavior != NULL) _behavior->processEvent(&_attributes, &_state, evt);  
 }
 
+bool OEntity::isEventThreadSafe() const
+{
+	return true;
+}
+
+void OEntity::processTimer(int timerId, const OTimeIndex & timeIndex)
+{
+	if (isDisabled()) return;
+	if (_behavior != NULL) _behavior->onTimer(&_attributes, &_state, timerId, timeIndex);
+}
+
 void OEntity::update(const OTimeIndex & timeIndex, int step_us)
 {
 	if (isDisabled()) return;
@@ -44,11 +60,49 @@ void OEntity::render(OMatrixStack * stack)
 {
 	if (isHidden()) return;
 	stack->push();
+	transform(stack);
+	_mesh->render(stack);
+	stack->pop();
+}
+
+void OEntity::submit(ORenderQueue * queue, OMatrixStack * stack)
+{
+	if (isHidden() || _mesh == NULL) return;
+	stack->push();
+	transform(stack);
+	_mesh->submit(queue, stack);
+	stack->pop();
+}
+
+void OEntity::transform(OMatrixStack * stack)
+{
 	stack->translate(_state.curr()->position());
 	*stack *= _state.curr()->orientation();
 	stack->scale(_state.curr()->scale());
-	_mesh->render(stack);
-	stack->pop();
+}
+
+bool OEntity::isStatic()
+{
+	return (_behavior == NULL && _state.curr()->isMotionless());
+}
+
+bool OEntity::boundingSphere(OVector3 & center, float & radius)
+{
+	OVector3 meshCenter;
+	float meshRadius;
+	if (_mesh == NULL || !_mesh->boundingSphere(meshCenter, meshRadius)) return false;
+
+	/* same transformation order as transform(): scale, then rotate and translate */
+	OState* state = _state.curr();
+	OVector3& scale = state->scale();
+	OVector3 scaled(meshCenter.x() * scale.x(), meshCenter.y() * scale.y(), meshCenter.z() * scale.z());
+	center = state->position() + state->orientation() * scaled;
+
+	float maxScale = fabsf(scale.x());
+	if (fabsf(scale.y()) > maxScale) maxScale = fabsf(scale.y());
+	if (fabsf(scale.z()) > maxScale) maxScale = fabsf(scale.z());
+	radius = meshRadius * maxScale;
+	return true;
 }
 
 void OEntity::setBehavior(OBehavior * behavior) 
@@ -86,6 +140,16 @@ void OEntity::setMesh(OMesh * mesh)
 	_mesh = mesh;
 }
 
+void OEntity::setOccluder(OMesh * occluder)
+{
+	_occluder = occluder;
+}
+
+OMesh * OEntity::occluder()
+{
+	return _occluder;
+}
+
 void OEntity::enable()
 {
 	_disabled = false;
@@ -100,3 +164,13 @@ bool OEntity::isDisabled() const
 {
 	return _disabled;
 }
+
+unsigned long long OEntity::visibilityRevision()
+{
+	return _visibilityRevision.load(std::memory_order_relaxed);
+}
+
+void OEntity::onVisibilityChange()
+{
+	_visibilityRevision++;
+}
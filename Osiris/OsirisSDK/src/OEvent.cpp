@@ -4,7 +4,8 @@
 // OEvent
 // ***********************************************************************
 OEvent::OEvent(OEvent::EventType type) :
-	_type(type)
+	_type(type),
+	_timestamp(0LL)
 {
 }
 
@@ -17,6 +18,16 @@ OEvent::EventType OEvent::type() const
 	return _type;
 }
 
+const OTimeIndex & OEvent::timestamp() const
+{
+	return _timestamp;
+}
+
+void OEvent::setTimestamp(const OTimeIndex & timestamp)
+{
+	_timestamp = timestamp;
+}
+
 // ***********************************************************************
 // OMemoryPoolEvent
 // ***********************************************************************
@@ -99,10 +110,12 @@ int OMouseClickEvent::y() const
 // ***********************************************************************
 // OMouseMoveEvent 
 // ***********************************************************************
-OMouseMoveEvent::OMouseMoveEvent(MovementType type, int x, int y) :
+OMouseMoveEvent::OMouseMoveEvent(MovementType type, int x, int y, int dx, int dy) :
 	OMemoryPoolEvent((type == ActiveMove) ? OEvent::MouseActiveMoveEvent : OEvent::MousePassiveMoveEvent),
 	_x(x),
-	_y(y)
+	_y(y),
+	_dx(dx),
+	_dy(dy)
 {
 }
 
@@ -120,6 +133,16 @@ int OMouseMoveEvent::y() const
 	return _y;
 }
 
+int OMouseMoveEvent::dx() const
+{
+	return _dx;
+}
+
+int OMouseMoveEvent::dy() const
+{
+	return _dy;
+}
+
 // ***********************************************************************
 // OResizeEvent
 // ***********************************************************************
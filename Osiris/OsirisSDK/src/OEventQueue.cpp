@@ -0,0 +1,127 @@
+#include "OsirisSDK/OException.h"
+
+#include "OsirisSDK/OEventQueue.h"
+
+using namespace std;
+
+// ***********************************************************************
+// OEventQueue::Record
+// ***********************************************************************
+OEventQueue::Record OEventQueue::Record::keyboard(OKeyboardPressEvent::KeyCode code, int mouse_x, int mouse_y,
+						    bool key_pressed)
+{
+	Record rec;
+	rec.timestamp_us = OTimeIndex::current().toMicroseconds();
+	rec.type = (key_pressed) ? OEvent::KeyboardPressEvent : OEvent::KeyboardReleaseEvent;
+	rec.data.keyboard.code = code;
+	rec.data.keyboard.mouse_x = mouse_x;
+	rec.data.keyboard.mouse_y = mouse_y;
+	return rec;
+}
+
+OEventQueue::Record OEventQueue::Record::mouseClick(OMouseClickEvent::MouseButton btn, OMouseClickEvent::MouseStatus status,
+						      int x, int y)
+{
+	Record rec;
+	rec.timestamp_us = OTimeIndex::current().toMicroseconds();
+	rec.type = OEvent::MouseClickEvent;
+	rec.data.mouseClick.button = btn;
+	rec.data.mouseClick.status = status;
+	rec.data.mouseClick.x = x;
+	rec.data.mouseClick.y = y;
+	return rec;
+}
+
+OEventQueue::Record OEventQueue::Record::mouseMove(OMouseMoveEvent::MovementType type, int x, int y, int dx, int dy)
+{
+	Record rec;
+	rec.timestamp_us = OTimeIndex::current().toMicroseconds();
+	rec.type = (type == OMouseMoveEvent::ActiveMove) ? OEvent::MouseActiveMoveEvent : OEvent::MousePassiveMoveEvent;
+	rec.data.mouseMove.x = x;
+	rec.data.mouseMove.y = y;
+	rec.data.mouseMove.dx = dx;
+	rec.data.mouseMove.dy = dy;
+	return rec;
+}
+
+OEventQueue::Record OEventQueue::Record::resize(int width, int height)
+{
+	Record rec;
+	rec.timestamp_us = OTimeIndex::current().toMicroseconds();
+	rec.type = OEvent::ResizeEvent;
+	rec.data.resize.width = width;
+	rec.data.resize.height = height;
+	return rec;
+}
+
+// ***********************************************************************
+// OEventQueue
+// ***********************************************************************
+OEventQueue::OEventQueue(int capacity) :
+	_enqueuePos(0),
+	_dequeuePos(0),
+	_dropped(0)
+{
+	if (capacity < 2) throw OException("Invalid event queue capacity.");
+
+	size_t size = 1;
+	while (size < (size_t)capacity) size <<= 1;
+	_mask = size - 1;
+
+	/* each cell sequence tells which enqueue position may write on it next */
+	_cells = new Cell[size];
+	for (size_t i = 0; i < size; i++) _cells[i].sequence.store(i, memory_order_relaxed);
+}
+
+OEventQueue::~OEventQueue()
+{
+	delete[] _cells;
+}
+
+int OEventQueue::capacity() const
+{
+	return (int)(_mask + 1);
+}
+
+bool OEventQueue::push(const Record & rec)
+{
+	Cell *cell;
+	size_t pos = _enqueuePos.load(memory_order_relaxed);
+	for (;;) {
+		cell = &_cells[pos & _mask];
+		size_t seq = cell->sequence.load(memory_order_acquire);
+		long long diff = (long long)seq - (long long)pos;
+		if (diff == 0) {
+			/* cell is free, try to claim this position */
+			if (_enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+		} else if (diff < 0) {
+			/* consumer has not released this cell yet: the queue is full */
+			_dropped.fetch_add(1, memory_order_relaxed);
+			return false;
+		} else {
+			/* another producer claimed the position, reload and retry */
+			pos = _enqueuePos.load(memory_order_relaxed);
+		}
+	}
+
+	cell->record = rec;
+	cell->sequence.store(pos + 1, memory_order_release);
+	return true;
+}
+
+bool OEventQueue::pop(Record * rec)
+{
+	Cell *cell = &_cells[_dequeuePos & _mask];
+	size_t seq = cell->sequence.load(memory_order_acquire);
+	if ((long long)seq - (long long)(_dequeuePos + 1) < 0) return false;
+
+	*rec = cell->record;
+	cell->sequence.store(_dequeuePos + _mask + 1, memory_order_release);
+	_dequeuePos++;
+	return true;
+}
+
+unsigned int OEventQueue::droppedCount() const
+{
+	return _dropped.load(memory_order_relaxed);
+}
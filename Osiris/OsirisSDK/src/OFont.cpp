@@ -1,5 +1,7 @@
 #include "OsirisSDK/OFont.h"
 #include "OsirisSDK/OException.h"
+#include "OsirisSDK/OProfiler.h"
+#include "OsirisSDK/OGLState.h"
 
 using namespace std;
 
@@ -44,8 +46,8 @@ void OFont::cleanCache()
 	map<int, CacheEntry*>::iterator it;
 	for (it = _cache.begin(); it != _cache.end(); it++) {
 		for (unsigned char c = 0; c < 255; c++) {
-			glDeleteTextures(1, (const GLuint*)&it->second[c].texId);
-			glDeleteBuffers(1, (const GLuint*)&it->second[c].arrBufId);
+			OGLState::deleteTextures(1, (const GLuint*)&it->second[c].texId);
+			OGLState::deleteBuffers(1, (const GLuint*)&it->second[c].arrBufId);
 		}
 		free(it->second);
 	}
@@ -74,6 +76,8 @@ int OFont::lineSpacing() const
 
 OFont::CacheEntry* OFont::loadGlyphs(int size)
 {
+	OPROFILE_ZONE("OFont::loadGlyphs");
+
 	if (FT_Set_Pixel_Sizes(_face, 0, size) != 0) throw OException("Unable to set font size.");
 
 	CacheEntry *entArray = (CacheEntry*) malloc(255 * sizeof(CacheEntry));
@@ -85,9 +89,9 @@ OFont::CacheEntry* OFont::loadGlyphs(int size)
 		entArray[character].advance_y = _face->glyph->advance.y;
 	
 		/* Activating texture unit and binding texture ID */
-		glActiveTexture(GL_TEXTURE0);
+		OGLState::activeTexture(GL_TEXTURE0);
 		glGenTextures(1, &entArray[character].texId);
-		glBindTexture(GL_TEXTURE_2D, entArray[character].texId);
+		OGLState::bindTexture(GL_TEXTURE_2D, entArray[character].texId);
 		
 		/* Clamping to edges is important to preventArray[character].artifacts when scaling */
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -100,11 +104,10 @@ OFont::CacheEntry* OFont::loadGlyphs(int size)
 		/* We require 1 byte alignmentArray[character].when uploading texture data */
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, _face->glyph->bitmap.width, _face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, _face->glyph->bitmap.buffer);
-		glBindTexture(GL_TEXTURE_2D, 0);
 
 		/* Now we estabilish the vertices that will delimeter the character box */
 		glGenBuffers(1, &entArray[character].arrBufId);
-		glBindBuffer(GL_ARRAY_BUFFER, entArray[character].arrBufId);
+		OGLState::bindBuffer(GL_ARRAY_BUFFER, entArray[character].arrBufId);
 		float x2 = (float)_face->glyph->bitmap_left;
 		float y2 = (float)-_face->glyph->bitmap_top;
 		float w = (float)_face->glyph->bitmap.width;
@@ -118,7 +121,6 @@ OFont::CacheEntry* OFont::loadGlyphs(int size)
 		};
 		
 		glBufferData(GL_ARRAY_BUFFER, 4*4*sizeof(GLfloat), boxVertices, GL_DYNAMIC_DRAW);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 	_cache[size] = entArray;
 	return entArray;
@@ -0,0 +1,115 @@
+#include <chrono>
+#include <thread>
+#include <stdlib.h>
+
+#include "OsirisSDK/OTimeIndex.h"
+
+#include "OsirisSDK/OFramePacer.h"
+
+using namespace std;
+
+OFramePacer::OFramePacer(int targetFPS, int statsSampleSize) :
+	_targetFPS(targetFPS),
+	_spinMargin_ns(OFRAMEPACER_DEFAULT_SPINMARGIN_US * 1000LL),
+	_deadline_ns(0),
+	_lastFrame_ns(0),
+	_lastFrameTime_us(0),
+	_overshoot_ns(0.0),
+	_frameTimeStats(statsSampleSize),
+	_jitterStats(statsSampleSize)
+{
+}
+
+OFramePacer::~OFramePacer()
+{
+}
+
+void OFramePacer::setTargetFPS(int targetFPS)
+{
+	_targetFPS = targetFPS;
+	_deadline_ns = 0;
+}
+
+int OFramePacer::targetFPS() const
+{
+	return _targetFPS;
+}
+
+void OFramePacer::setSpinMargin(int spinMargin_us)
+{
+	_spinMargin_ns = spinMargin_us * 1000LL;
+}
+
+int OFramePacer::spinMargin() const
+{
+	return (int)(_spinMargin_ns / 1000);
+}
+
+int OFramePacer::wait()
+{
+	long long start_ns = now();
+	long long end_ns = start_ns;
+
+	if (_targetFPS > 0) {
+		long long interval_ns = 1000000000LL / _targetFPS;
+
+		/* next deadline, unless it is already more than an interval behind */
+		_deadline_ns += interval_ns;
+		if (_deadline_ns < start_ns - interval_ns) _deadline_ns = start_ns;
+
+		/* sleeping until shortly before the deadline... */
+		long long wakeup_ns = _deadline_ns - _spinMargin_ns - (long long)_overshoot_ns;
+		if (wakeup_ns > start_ns) {
+			this_thread::sleep_for(chrono::nanoseconds(wakeup_ns - start_ns));
+			end_ns = now();
+			_overshoot_ns += OFRAMEPACER_OVERSHOOT_WEIGHT * ((end_ns - wakeup_ns) - _overshoot_ns);
+		}
+
+		/* ...and yielding for the rest of the interval */
+		while (end_ns < _deadline_ns) {
+			this_thread::yield();
+			end_ns = now();
+		}
+	}
+
+	/* frame time and jitter */
+	if (_lastFrame_ns > 0) {
+		int frameTime_us = (int)((end_ns - _lastFrame_ns) / 1000);
+		int reference_us = (_targetFPS > 0) ? 1000000 / _targetFPS : _lastFrameTime_us;
+		_frameTimeStats.add(frameTime_us);
+		if (reference_us > 0) _jitterStats.add(abs(frameTime_us - reference_us));
+		_lastFrameTime_us = frameTime_us;
+	}
+	_lastFrame_ns = end_ns;
+
+	return (int)((end_ns - start_ns) / 1000);
+}
+
+void OFramePacer::reset()
+{
+	_deadline_ns = 0;
+	_lastFrame_ns = 0;
+	_lastFrameTime_us = 0;
+	_frameTimeStats.clear();
+	_jitterStats.clear();
+}
+
+float OFramePacer::overshootEstimate() const
+{
+	return (float)(_overshoot_ns / 1000.0);
+}
+
+const OStats<int>& OFramePacer::frameTimeStats() const
+{
+	return _frameTimeStats;
+}
+
+const OStats<int>& OFramePacer::jitterStats() const
+{
+	return _jitterStats;
+}
+
+long long OFramePacer::now()
+{
+	return OTimeIndex::fromTicks(OTimeIndex::ticks()).toNanoseconds();
+}
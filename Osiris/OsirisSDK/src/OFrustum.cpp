@@ -0,0 +1,128 @@
+#include <math.h>
+
+#include "OsirisSDK/OFrustum.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#	define OFRUSTUM_SSE
+#	include <xmmintrin.h>
+#endif
+
+OFrustum::OFrustum()
+{
+	/* planes that every point is inside of */
+	for (int i = 0; i < PlaneCount; i++) {
+		_a[i] = _b[i] = _c[i] = 0.0f;
+		_d[i] = 1.0f;
+	}
+}
+
+OFrustum::~OFrustum()
+{
+}
+
+void OFrustum::setMatrix(const OMatrix4x4 & viewProjection)
+{
+	/* each plane is the sum or difference of the fourth row and one of the others (column-major storage) */
+	const GLfloat* m = viewProjection.glArea();
+	for (int i = 0; i < PlaneCount; i++) {
+		int row = i / 2;
+		float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+		_a[i] = m[3] + sign * m[row];
+		_b[i] = m[7] + sign * m[4 + row];
+		_c[i] = m[11] + sign * m[8 + row];
+		_d[i] = m[15] + sign * m[12 + row];
+
+		/* normalized, so that the plane equation gives the distance to the plane */
+		float len = sqrtf(_a[i] * _a[i] + _b[i] * _b[i] + _c[i] * _c[i]);
+		if (len > 0.0f) {
+			_a[i] /= len;
+			_b[i] /= len;
+			_c[i] /= len;
+			_d[i] /= len;
+		}
+	}
+}
+
+OVector4 OFrustum::plane(Plane p) const
+{
+	return OVector4(_a[p], _b[p], _c[p], _d[p]);
+}
+
+bool OFrustum::intersects(const OVector3 & center, float radius) const
+{
+	for (int i = 0; i < PlaneCount; i++) {
+		if (_a[i] * center.x() + _b[i] * center.y() + _c[i] * center.z() + _d[i] < -radius) return false;
+	}
+	return true;
+}
+
+OFrustum::Intersection OFrustum::classify(const float * min, const float * max, unsigned int & planeMask) const
+{
+	for (int p = 0; p < PlaneCount; p++) {
+		if (!(planeMask & (1 << p))) continue;
+
+		/* box corners farthest along the plane normal, and farthest against it */
+		float farDist = _a[p] * ((_a[p] >= 0.0f) ? max[0] : min[0]) + _b[p] * ((_b[p] >= 0.0f) ? max[1] : min[1]) +
+			    _c[p] * ((_c[p] >= 0.0f) ? max[2] : min[2]) + _d[p];
+		if (farDist < 0.0f) return Outside;
+		float nearDist = _a[p] * ((_a[p] >= 0.0f) ? min[0] : max[0]) + _b[p] * ((_b[p] >= 0.0f) ? min[1] : max[1]) +
+			     _c[p] * ((_c[p] >= 0.0f) ? min[2] : max[2]) + _d[p];
+		if (nearDist >= 0.0f) planeMask &= ~(1 << p);
+	}
+	return (planeMask == 0) ? Inside : Intersecting;
+}
+
+int OFrustum::intersects(const float * x, const float * y, const float * z, const float * radius, int count,
+			 unsigned char * visible) const
+{
+	int visibleCount = 0;
+	int i = 0;
+
+#ifdef OFRUSTUM_SSE
+	/* a batch of OFRUSTUM_BATCH spheres at a time, four per SSE register */
+	static const int lanes = 4;
+	for (; i + OFRUSTUM_BATCH <= count; i += OFRUSTUM_BATCH) {
+		__m128 inside[OFRUSTUM_BATCH / lanes];
+		__m128 cx[OFRUSTUM_BATCH / lanes], cy[OFRUSTUM_BATCH / lanes], cz[OFRUSTUM_BATCH / lanes];
+		__m128 negRadius[OFRUSTUM_BATCH / lanes];
+		for (int l = 0; l < OFRUSTUM_BATCH / lanes; l++) {
+			cx[l] = _mm_loadu_ps(x + i + l * lanes);
+			cy[l] = _mm_loadu_ps(y + i + l * lanes);
+			cz[l] = _mm_loadu_ps(z + i + l * lanes);
+			negRadius[l] = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i + l * lanes));
+			inside[l] = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+		}
+		for (int p = 0; p < PlaneCount; p++) {
+			__m128 a = _mm_set1_ps(_a[p]);
+			__m128 b = _mm_set1_ps(_b[p]);
+			__m128 c = _mm_set1_ps(_c[p]);
+			__m128 d = _mm_set1_ps(_d[p]);
+			for (int l = 0; l < OFRUSTUM_BATCH / lanes; l++) {
+				__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, cx[l]), _mm_mul_ps(b, cy[l])),
+							 _mm_add_ps(_mm_mul_ps(c, cz[l]), d));
+				inside[l] = _mm_and_ps(inside[l], _mm_cmpge_ps(dist, negRadius[l]));
+			}
+		}
+		for (int l = 0; l < OFRUSTUM_BATCH / lanes; l++) {
+			int mask = _mm_movemask_ps(inside[l]);
+			for (int k = 0; k < lanes; k++) {
+				visible[i + l * lanes + k] = (unsigned char)((mask >> k) & 1);
+				visibleCount += (mask >> k) & 1;
+			}
+		}
+	}
+#endif
+
+	/* remaining spheres (or all of them, without SSE) */
+	for (; i < count; i++) {
+		bool in = true;
+		for (int p = 0; p < PlaneCount && in; p++) {
+			if (_a[p] * x[i] + _b[p] * y[i] + _c[p] * z[i] + _d[p] < -radius[i]) in = false;
+		}
+		visible[i] = (in) ? 1 : 0;
+		if (in) visibleCount++;
+	}
+
+	return visibleCount;
+}
+
@@ -0,0 +1,47 @@
+#include "OsirisSDK/OGLCounters.h"
+
+int OGLCounters::_current[OGLCounters::CategoryCount] = { 0 };
+int OGLCounters::_lastFrame[OGLCounters::CategoryCount] = { 0 };
+
+bool OGLCounters::enabled()
+{
+#ifdef OSIRIS_GL_COUNTERS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void OGLCounters::newFrame()
+{
+	for (int i = 0; i < CategoryCount; i++) {
+		_lastFrame[i] = _current[i];
+		_current[i] = 0;
+	}
+}
+
+int OGLCounters::frameCount(Category category)
+{
+	return _lastFrame[category];
+}
+
+int OGLCounters::currentCount(Category category)
+{
+	return _current[category];
+}
+
+const char * OGLCounters::categoryName(Category category)
+{
+	switch (category) {
+	case DrawCalls:		return "draws";
+	case ProgramBinds:	return "program binds";
+	case VertexArrayBinds:	return "VAO binds";
+	case BufferBinds:	return "buffer binds";
+	case BufferUploads:	return "buffer uploads";
+	case TextureBinds:	return "texture binds";
+	case UniformUploads:	return "uniform uploads";
+	case LocationQueries:	return "location queries";
+	case StateChanges:	return "state changes";
+	default:		return "";
+	}
+}
@@ -0,0 +1,109 @@
+#include "OsirisSDK/OGLState.h"
+
+GLuint OGLState::_program;
+GLuint OGLState::_vertexArray;
+GLuint OGLState::_buffers[OGLState::BufferTargetCount];
+GLuint OGLState::_uniformBindings[OGLSTATE_UNIFORMBINDINGS];
+GLuint OGLState::_activeTexture;
+GLuint OGLState::_textures[OGLSTATE_TEXTUREUNITS];
+GLuint OGLState::_capabilities[OGLState::CapabilityCount];
+GLuint OGLState::_blendSrc;
+GLuint OGLState::_blendDst;
+GLuint OGLState::_cullFace;
+GLuint OGLState::_frontFace;
+GLuint OGLState::_depthMask;
+GLuint OGLState::_depthFunc;
+
+int OGLState::_issued = 0;
+int OGLState::_skipped = 0;
+int OGLState::_frameIssued = 0;
+int OGLState::_frameSkipped = 0;
+
+/* the shadow state starts unknown */
+static struct OGLStateInitializer {
+	OGLStateInitializer() { OGLState::invalidate(); }
+} _oglStateInitializer;
+
+bool OGLState::isEnabled(GLenum capability)
+{
+	int idx = capabilityIndex(capability);
+	if (idx < 0) return (glIsEnabled(capability) == GL_TRUE);
+	if (_capabilities[idx] == Unknown) _capabilities[idx] = (glIsEnabled(capability) == GL_TRUE) ? GL_TRUE : GL_FALSE;
+	return (_capabilities[idx] == GL_TRUE);
+}
+
+void OGLState::deleteBuffers(GLsizei n, const GLuint * buffers)
+{
+	for (GLsizei i = 0; i < n; i++) {
+		for (int j = 0; j < BufferTargetCount; j++) {
+			if (_buffers[j] == buffers[i]) _buffers[j] = 0;
+		}
+		for (int j = 0; j < OGLSTATE_UNIFORMBINDINGS; j++) {
+			if (_uniformBindings[j] == buffers[i]) _uniformBindings[j] = 0;
+		}
+	}
+	glDeleteBuffers(n, buffers);
+}
+
+void OGLState::deleteVertexArrays(GLsizei n, const GLuint * vertexArrays)
+{
+	for (GLsizei i = 0; i < n; i++) {
+		if (_vertexArray == vertexArrays[i]) {
+			_vertexArray = 0;
+			_buffers[ElementArrayBuffer] = Unknown;
+		}
+	}
+	glDeleteVertexArrays(n, vertexArrays);
+}
+
+void OGLState::deleteTextures(GLsizei n, const GLuint * textures)
+{
+	for (GLsizei i = 0; i < n; i++) {
+		for (int j = 0; j < OGLSTATE_TEXTUREUNITS; j++) {
+			if (_textures[j] == textures[i]) _textures[j] = 0;
+		}
+	}
+	glDeleteTextures(n, textures);
+}
+
+void OGLState::deleteProgram(GLuint program)
+{
+	/* a program in use is only deleted once it is no longer current */
+	if (_program == program) _program = Unknown;
+	glDeleteProgram(program);
+}
+
+void OGLState::invalidate()
+{
+	_program = Unknown;
+	_vertexArray = Unknown;
+	for (int i = 0; i < BufferTargetCount; i++) _buffers[i] = Unknown;
+	for (int i = 0; i < OGLSTATE_UNIFORMBINDINGS; i++) _uniformBindings[i] = Unknown;
+	_activeTexture = Unknown;
+	for (int i = 0; i < OGLSTATE_TEXTUREUNITS; i++) _textures[i] = Unknown;
+	for (int i = 0; i < CapabilityCount; i++) _capabilities[i] = Unknown;
+	_blendSrc = Unknown;
+	_blendDst = Unknown;
+	_cullFace = Unknown;
+	_frontFace = Unknown;
+	_depthMask = Unknown;
+	_depthFunc = Unknown;
+}
+
+void OGLState::newFrame()
+{
+	_frameIssued = _issued;
+	_frameSkipped = _skipped;
+	_issued = 0;
+	_skipped = 0;
+}
+
+int OGLState::frameIssued()
+{
+	return _frameIssued;
+}
+
+int OGLState::frameSkipped()
+{
+	return _frameSkipped;
+}
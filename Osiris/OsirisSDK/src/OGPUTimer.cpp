@@ -0,0 +1,154 @@
+#include <string.h>
+
+#include "OsirisSDK/OGPUTimer.h"
+
+using namespace std;
+
+// ***********************************************************************
+// OGPUTimer
+// ***********************************************************************
+vector<OGPUTimer::Pass*> OGPUTimer::_passes;
+bool OGPUTimer::_enabled = false;
+int OGPUTimer::_frame = 0;
+int OGPUTimer::_droppedFrameCount = 0;
+
+void OGPUTimer::setEnabled(bool enabled)
+{
+	if (enabled) {
+		/* implementations may expose timer queries with a zero-bit (unusable) timestamp counter */
+		GLint bits = 0;
+		glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+		if (bits == 0) enabled = false;
+	}
+	_enabled = enabled;
+}
+
+bool OGPUTimer::enabled()
+{
+	return _enabled;
+}
+
+int OGPUTimer::pass(const char * name)
+{
+	for (size_t i = 0; i < _passes.size(); i++) {
+		if (strcmp(_passes[i]->name, name) == 0) return (int)i;
+	}
+	Pass *pass = new Pass;
+	pass->name = name;
+	pass->stats.setSampleSize(OGPUTIMER_STATSSAMPLE);
+	for (int i = 0; i < OGPUTIMER_FRAMELATENCY; i++) pass->used[i] = 0;
+	_passes.push_back(pass);
+	return (int)_passes.size() - 1;
+}
+
+int OGPUTimer::begin(int passId)
+{
+	if (!_enabled) return -1;
+
+	int slot = _frame % OGPUTIMER_FRAMELATENCY;
+	Pass *pass = _passes[passId];
+	vector<GLuint>& queries = pass->queries[slot];
+	int token = pass->used[slot];
+	if (token == (int)queries.size()) {
+		queries.resize(token + 2);
+		glGenQueries(2, &queries[token]);
+	}
+	pass->used[slot] += 2;
+	glQueryCounter(queries[token], GL_TIMESTAMP);
+	return token;
+}
+
+void OGPUTimer::end(int passId, int token)
+{
+	if (token < 0) return;
+	int slot = _frame % OGPUTIMER_FRAMELATENCY;
+	glQueryCounter(_passes[passId]->queries[slot][token + 1], GL_TIMESTAMP);
+}
+
+void OGPUTimer::newFrame()
+{
+	_frame++;
+	int slot = _frame % OGPUTIMER_FRAMELATENCY;
+
+	/* collecting the results of the frame that last used the slot about to be reused */
+	bool dropped = false;
+	for (size_t i = 0; i < _passes.size(); i++) {
+		Pass *pass = _passes[i];
+		int used = pass->used[slot];
+		if (used == 0) continue;
+		pass->used[slot] = 0;
+
+		vector<GLuint>& queries = pass->queries[slot];
+		GLint available = 0;
+		glGetQueryObjectiv(queries[used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			dropped = true;
+			continue;
+		}
+
+		GLuint64 total_ns = 0;
+		for (int j = 0; j < used; j += 2) {
+			GLuint64 start_ns, end_ns;
+			glGetQueryObjectui64v(queries[j], GL_QUERY_RESULT, &start_ns);
+			glGetQueryObjectui64v(queries[j + 1], GL_QUERY_RESULT, &end_ns);
+			total_ns += end_ns - start_ns;
+		}
+		pass->stats.add(total_ns / 1000.0f);
+	}
+	if (dropped) _droppedFrameCount++;
+}
+
+int OGPUTimer::passCount()
+{
+	return (int)_passes.size();
+}
+
+const char * OGPUTimer::passName(int passId)
+{
+	return _passes[passId]->name;
+}
+
+const OStats<float>& OGPUTimer::passStats(int passId)
+{
+	return _passes[passId]->stats;
+}
+
+const OStats<float>* OGPUTimer::passStats(const char * name)
+{
+	for (size_t i = 0; i < _passes.size(); i++) {
+		if (strcmp(_passes[i]->name, name) == 0) return &_passes[i]->stats;
+	}
+	return NULL;
+}
+
+int OGPUTimer::droppedFrameCount()
+{
+	return _droppedFrameCount;
+}
+
+void OGPUTimer::release()
+{
+	/* passes are kept, since their identifiers may be cached on static variables */
+	for (size_t i = 0; i < _passes.size(); i++) {
+		for (int j = 0; j < OGPUTIMER_FRAMELATENCY; j++) {
+			vector<GLuint>& queries = _passes[i]->queries[j];
+			if (!queries.empty()) glDeleteQueries((GLsizei)queries.size(), &queries[0]);
+			queries.clear();
+			_passes[i]->used[j] = 0;
+		}
+	}
+}
+
+// ***********************************************************************
+// OGPUTimerScope
+// ***********************************************************************
+OGPUTimerScope::OGPUTimerScope(int passId) :
+	_passId(passId),
+	_token(OGPUTimer::begin(passId))
+{
+}
+
+OGPUTimerScope::~OGPUTimerScope()
+{
+	OGPUTimer::end(_passId, _token);
+}
@@ -0,0 +1,65 @@
+#include <string>
+
+#include "OsirisSDK/OException.h"
+
+#include "OsirisSDK/OInputRecorder.h"
+
+using namespace std;
+
+OInputRecorder::OInputRecorder(const char * filename, const OTimeIndex & startTime) :
+	_startTime_us(startTime.toMicroseconds()),
+	_count(0)
+{
+#ifdef WIN32
+	fopen_s(&_fp, filename, "wb");
+#else
+	_fp = fopen(filename, "wb");
+#endif
+	if (!_fp) throw OException((string("Error opening input log file: '") + filename + "'.").c_str());
+
+	unsigned int version = OINPUTRECORDER_VERSION;
+	if (fwrite(OINPUTRECORDER_MAGIC, 8, 1, _fp) != 1 || fwrite(&version, sizeof(version), 1, _fp) != 1) {
+		fclose(_fp);
+		throw OException((string("Error writing input log file: '") + filename + "'.").c_str());
+	}
+}
+
+OInputRecorder::~OInputRecorder()
+{
+	if (_fp != NULL) fclose(_fp);
+}
+
+void OInputRecorder::record(const OTimeIndex & simulationTime, const OEventQueue::Record & rec)
+{
+	Entry entry;
+	entry.simulationTime_us = simulationTime.toMicroseconds() - _startTime_us;
+	entry.record = rec;
+	if (!writeEntry(_fp, entry)) throw OException("Error writing input log file.");
+	_count++;
+}
+
+int OInputRecorder::count() const
+{
+	return _count;
+}
+
+bool OInputRecorder::writeEntry(FILE * fp, const Entry & entry)
+{
+	int type = entry.record.type;
+	if (fwrite(&entry.simulationTime_us, sizeof(entry.simulationTime_us), 1, fp) != 1) return false;
+	if (fwrite(&type, sizeof(type), 1, fp) != 1) return false;
+	if (fwrite(&entry.record.data, sizeof(entry.record.data), 1, fp) != 1) return false;
+	return true;
+}
+
+bool OInputRecorder::readEntry(FILE * fp, Entry * entry)
+{
+	int type;
+	if (fread(&entry->simulationTime_us, sizeof(entry->simulationTime_us), 1, fp) != 1) return false;
+	if (fread(&type, sizeof(type), 1, fp) != 1) return false;
+	if (fread(&entry->record.data, sizeof(entry->record.data), 1, fp) != 1) return false;
+	if (type < OEvent::KeyboardPressEvent || type > OEvent::ResizeEvent) return false;
+	entry->record.type = (OEvent::EventType)type;
+	entry->record.timestamp_us = 0;
+	return true;
+}
@@ -0,0 +1,69 @@
+#include <string.h>
+#include <string>
+
+#include "OsirisSDK/OException.h"
+#include "OsirisSDK/OApplication.h"
+
+#include "OsirisSDK/OInputReplay.h"
+
+using namespace std;
+
+OInputReplay::OInputReplay(const char * filename, const OTimeIndex & startTime) :
+	_next(0),
+	_droppedCount(0),
+	_startTime_us(startTime.toMicroseconds())
+{
+	FILE *fp;
+#ifdef WIN32
+	fopen_s(&fp, filename, "rb");
+#else
+	fp = fopen(filename, "rb");
+#endif
+	if (!fp) throw OException((string("Error opening input log file: '") + filename + "'.").c_str());
+
+	char magic[8];
+	unsigned int version;
+	if (fread(magic, sizeof(magic), 1, fp) != 1 || memcmp(magic, OINPUTRECORDER_MAGIC, sizeof(magic)) != 0 ||
+	    fread(&version, sizeof(version), 1, fp) != 1 || version != OINPUTRECORDER_VERSION) {
+		fclose(fp);
+		throw OException((string("Invalid input log file: '") + filename + "'.").c_str());
+	}
+
+	OInputRecorder::Entry entry;
+	while (OInputRecorder::readEntry(fp, &entry)) _entries.push_back(entry);
+	fclose(fp);
+}
+
+OInputReplay::~OInputReplay()
+{
+}
+
+int OInputReplay::inject(OApplication * app, const OTimeIndex & simulationTime)
+{
+	long long offset_us = simulationTime.toMicroseconds() - _startTime_us;
+	long long now_us = OTimeIndex::current().toMicroseconds();
+	int count = 0;
+	while (_next < _entries.size() && _entries[_next].simulationTime_us <= offset_us) {
+		OEventQueue::Record rec = _entries[_next].record;
+		rec.timestamp_us = now_us;
+		if (app->queueEvent(rec)) count++;
+		else _droppedCount++;
+		_next++;
+	}
+	return count;
+}
+
+bool OInputReplay::finished() const
+{
+	return (_next >= _entries.size());
+}
+
+int OInputReplay::count() const
+{
+	return (int)_entries.size();
+}
+
+int OInputReplay::droppedCount() const
+{
+	return _droppedCount;
+}
@@ -18,7 +18,7 @@ OMemoryPool::OMemoryPool(size_t blockSize, size_t segmentCount) :
 OMemoryPool::~OMemoryPool()
 {
 	while (!_segmentStack.empty()) {
-		free(_segmentStack.top());
+		::free(_segmentStack.top());
 		_segmentStack.pop();
 	}
 }
@@ -1,26 +1,40 @@
 #include "OsirisSDK/OException.h"
+#include "OsirisSDK/OProfiler.h"
+#include "OsirisSDK/OGPUTimer.h"
+#include "OsirisSDK/OGLState.h"
 #include "OsirisSDK/OMesh.h"
 
 #include <stdio.h>
+#include <math.h>
 
 OMesh::OMesh(OShaderProgram *program) :
 	_vaoObject(0),
 	_vertexCount(0),
 	_faceCount(0),
 	_program(program),
+	_instanceBufferObject(0),
+	_instanceBufferCapacity(0),
+	_blending(false),
+	_boundsRadius(-1.0f),
 	_cullEnabled(false),
 	_cullFace(CullFace_Undefined),
 	_cullFront(CullFront_Undefined)
 {
+	setProgram(program);
 }
 
 OMesh::~OMesh()
 {
+	if (_instanceBufferObject != 0) OGLState::deleteBuffers(1, &_instanceBufferObject);
 }
 
 void OMesh::setProgram(OShaderProgram * program)
 {
 	_program = program;
+
+	/* uniform handles are resolved once per program */
+	_modelMtxUniform = (_program != NULL) ? _program->uniformHandle("modelMtx") : -1;
+	_instancedUniform = (_program != NULL) ? _program->uniformHandle("instanced") : -1;
 }
 
 OShaderProgram * OMesh::getProgram()
@@ -77,62 +91,163 @@ void OMesh::init()
 
 	/* init & bind VAO */
 	glGenVertexArrays(1, &_vaoObject);
-	glBindVertexArray(_vaoObject);
+	OGLState::bindVertexArray(_vaoObject);
 	
 	/* setup and bind vertex/index array */
 	vertexArray = _vertexBuffer.generateGLBufferObject(GL_ARRAY_BUFFER);
-	glBindBuffer(GL_ARRAY_BUFFER, vertexArray);
+	OGLState::bindBuffer(GL_ARRAY_BUFFER, vertexArray);
 	indexArray = _indexBuffer.generateGLBufferObject(GL_ELEMENT_ARRAY_BUFFER);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexArray);
+	OGLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexArray);
 
 	/* setup attribute array -- for use inside sharers */
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
 	setupAdditionalVertexArrays();
 
-	/* unbind VAO & buffer object */
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	/* per-instance model matrix, one column per attribute location: the buffer starts with an identity
+	   matrix, so that non-instanced draws never fetch beyond its end */
+	const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+	glGenBuffers(1, &_instanceBufferObject);
+	OGLState::bindBuffer(GL_ARRAY_BUFFER, _instanceBufferObject);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(identity), identity, GL_STREAM_DRAW);
+	_instanceBufferCapacity = sizeof(identity);
+	for (int i = 0; i < 4; i++) {
+		glEnableVertexAttribArray(OMESH_INSTANCEMTX_LOCATION + i);
+		glVertexAttribPointer(OMESH_INSTANCEMTX_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(identity),
+				      (void*)(i * 4 * sizeof(float)));
+		glVertexAttribDivisor(OMESH_INSTANCEMTX_LOCATION + i, 1);
+	}
+
+	/* unbind VAO, so that it is not changed by accident */
+	OGLState::bindVertexArray(0);
+
+	/* bounding sphere around the vertices bounding box, for view-frustum culling */
+	if (_vertexCount > 0) {
+		OVector3 vmin = vertexData(0);
+		OVector3 vmax = vmin;
+		for (int i = 1; i < _vertexCount; i++) {
+			OVector3 v = vertexData(i);
+			vmin = OVector3(fminf(vmin.x(), v.x()), fminf(vmin.y(), v.y()), fminf(vmin.z(), v.z()));
+			vmax = OVector3(fmaxf(vmax.x(), v.x()), fmaxf(vmax.y(), v.y()), fmaxf(vmax.z(), v.z()));
+		}
+		_boundsCenter = (vmin + vmax) * 0.5f;
+		OVector3 halfSize = (vmax - vmin) * 0.5f;
+		_boundsRadius = sqrtf(halfSize.dot(halfSize));
+	}
+}
+
+bool OMesh::boundingSphere(OVector3 & center, float & radius)
+{
+	if (_boundsRadius < 0.0f) return false;
+	center = _boundsCenter;
+	radius = _boundsRadius;
+	return true;
 }
 
 void OMesh::render(OMatrixStack *mtx)
 {
-	/* check if there is a shader program defined */
-	if (_program == NULL) throw OException("Mesh defined without a shader program.");
+	OPROFILE_ZONE("OMesh::render");
+	bindState();
+	draw(mtx->top(), 0);
+}
 
-	/* bind VAO */
-	glBindVertexArray(_vaoObject);
+void OMesh::renderInstanced(OMatrixStack * mtx, const float * instanceMtx, int instanceCount)
+{
+	OPROFILE_ZONE("OMesh::renderInstanced");
+	if (instanceCount <= 0) return;
+	uploadInstances(instanceMtx, instanceCount);
+	bindState();
+	draw(mtx->top(), instanceCount);
+}
+
+void OMesh::submit(ORenderQueue * queue, OMatrixStack * stack)
+{
+	if (isHidden()) return;
+
+	/* the distance from the camera is the w coordinate of the mesh origin, in clip space */
+	OMatrix4x4 transform = stack->top();
+	const GLfloat* vp = queue->viewProjection().glArea();
+	const GLfloat* origin = transform.glArea() + 12;
+	float depth = vp[3] * origin[0] + vp[7] * origin[1] + vp[11] * origin[2] + vp[15] * origin[3];
+	queue->submit(this, transform, (_blending) ? ORenderQueue::Pass_Blended : ORenderQueue::Pass_Opaque,
+		      (_program != NULL) ? _program->glReference() : 0, _vaoObject, depth);
+}
 
-	/* bind vertex buffer */
-	glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer.glReference()); 
+void OMesh::submitInstanced(ORenderQueue * queue, OMatrixStack * stack, const float * instanceMtx, int instanceCount)
+{
+	if (isHidden() || instanceCount <= 0) return;
+	queue->submit(this, stack->top(), (_blending) ? ORenderQueue::Pass_Blended : ORenderQueue::Pass_Opaque,
+		      (_program != NULL) ? _program->glReference() : 0, _vaoObject, 0.0f, instanceMtx, instanceCount);
+}
 
-	/* prepare program -- assign necessary transformations */
+void OMesh::renderItem(const ORenderQueue::Item & item, bool stateBound)
+{
+	OPROFILE_ZONE("OMesh::renderItem");
+	if (item.instanceCount > 0) uploadInstances(item.instanceMtx, item.instanceCount);
+	if (!stateBound) bindState();
+	draw(item.transform, item.instanceCount);
+}
+
+void OMesh::setBlending(bool enabled)
+{
+	_blending = enabled;
+}
+
+bool OMesh::blending() const
+{
+	return _blending;
+}
+
+void OMesh::uploadInstances(const float * instanceMtx, int instanceCount)
+{
+	/* streaming the matrices: the buffer storage is orphaned on every upload, so that the driver doesn't
+	   have to wait for the previous frame draws to finish reading it */
+	size_t size = instanceCount * 16 * sizeof(float);
+	if (size > _instanceBufferCapacity) {
+		_instanceBufferCapacity = (size > 2 * _instanceBufferCapacity) ? size : 2 * _instanceBufferCapacity;
+	}
+	OGLState::bindBuffer(GL_ARRAY_BUFFER, _instanceBufferObject);
+	glBufferData(GL_ARRAY_BUFFER, _instanceBufferCapacity, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, instanceMtx);
+}
+
+void OMesh::bindState()
+{
+	/* check if there is a shader program defined */
+	if (_program == NULL) throw OException("Mesh defined without a shader program.");
+	if (_cullEnabled && (_cullFace == CullFace_Undefined || _cullFront == CullFront_Undefined)) {
+		throw OException("Invalid face culling configuration");
+	}
+
+	/* bind VAO & program; bindings are left in place after drawing, the state cache skips them if the next
+	   draw uses the same ones */
+	OGLState::bindVertexArray(_vaoObject);
 	_program->use();
-	glUniformMatrix4fv(_program->uniformLocation("transformMtx"), 1, GL_FALSE, mtx->top().glArea());
-	setupAdditionalShaderLocations();
 
 	/* face culling */
 	if (_cullEnabled) {
-		if (_cullFace == CullFace_Undefined || _cullFront == CullFront_Undefined) {
-			glBindVertexArray(0);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-			glUseProgram(0);
-			throw OException("Invalid face culling configuration");
-		}
-		glEnable(GL_CULL_FACE);
-		glCullFace(_cullFace);
-		glFrontFace(_cullFront);
+		OGLState::enable(GL_CULL_FACE);
+		OGLState::cullFace(_cullFace);
+		OGLState::frontFace(_cullFront);
 	} else {
-		glDisable(GL_CULL_FACE);
+		OGLState::disable(GL_CULL_FACE);
 	}
+}
 
-	/* draw */
-	glDrawElements(GL_TRIANGLES, _indexBuffer.count(), GL_UNSIGNED_INT, 0);
+void OMesh::draw(const OMatrix4x4& transform, int instanceCount)
+{
+	/* assign the model matrix: the camera matrices come from the camera uniform buffer */
+	_program->setUniform(_modelMtxUniform, transform);
+	_program->setUniform(_instancedUniform, (GLint)((instanceCount > 0) ? 1 : 0));
+	setupAdditionalShaderLocations();
 
-	/* unbind everything */
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-	glUseProgram(0);
+	/* draw */
+	OGPUTIMER_SCOPE("OMesh::draw");
+	if (instanceCount > 0) {
+		glDrawElementsInstanced(GL_TRIANGLES, _indexBuffer.count(), GL_UNSIGNED_INT, 0, instanceCount);
+	} else {
+		glDrawElements(GL_TRIANGLES, _indexBuffer.count(), GL_UNSIGNED_INT, 0);
+	}
 }
 
 void OMesh::setFaceCulling(bool enabled, CullFace face, CullFront front)
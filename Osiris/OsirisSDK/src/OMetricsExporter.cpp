@@ -0,0 +1,235 @@
+#include <new>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "OsirisSDK/OException.h"
+#include "OsirisSDK/OTimeIndex.h"
+
+#include "OsirisSDK/OMetricsExporter.h"
+
+using namespace std;
+
+template<class VType>
+void OMetricsExporter::sampleStats(const OStats<VType>* stats, OMetricsValues * values)
+{
+	values->sampleCount = stats->count();
+	values->last = (float)stats->last();
+	values->average = stats->average();
+	values->stdev = stats->stdev();
+	values->minValue = (float)stats->minValue();
+	values->maxValue = (float)stats->maxValue();
+	values->p50 = (float)stats->percentile(50);
+	values->p99 = (float)stats->percentile(99);
+}
+
+OMetricsExporter::OMetricsExporter(const char * filename, int interval_us) :
+	_file(NULL),
+	_interval_us(interval_us),
+	_lastExport_ns(0),
+	_sink(NULL),
+	_sinkFormat(CSVSink),
+	_sinkHeaderWritten(false)
+{
+	size_t size = sizeof(OMetricsFile);
+#ifdef WIN32
+	_mappingHandle = NULL;
+	_fileHandle = CreateFileA(filename, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+				  CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (_fileHandle != INVALID_HANDLE_VALUE) {
+		_mappingHandle = CreateFileMappingA(_fileHandle, NULL, PAGE_READWRITE, 0, (DWORD)size, NULL);
+		if (_mappingHandle != NULL) _file = (OMetricsFile*)MapViewOfFile(_mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	}
+	if (_file == NULL) {
+		if (_mappingHandle != NULL) CloseHandle(_mappingHandle);
+		if (_fileHandle != INVALID_HANDLE_VALUE) CloseHandle(_fileHandle);
+		throw OException((string("Error mapping metrics file: '") + filename + "'.").c_str());
+	}
+#else
+	_fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (_fd >= 0 && ftruncate(_fd, size) == 0) {
+		void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+		if (addr != MAP_FAILED) _file = (OMetricsFile*)addr;
+	}
+	if (_file == NULL) {
+		if (_fd >= 0) close(_fd);
+		throw OException((string("Error mapping metrics file: '") + filename + "'.").c_str());
+	}
+#endif
+
+	/* the header is published last, so that readers never see a valid magic on a partial header */
+	memset((void*)_file, 0, size);
+	_file = new ((void*)_file) OMetricsFile();
+	_file->header.version = OMETRICS_VERSION;
+	_file->header.recordCapacity = OMETRICS_MAXRECORDS;
+	_file->header.recordSize = sizeof(OMetricsRecord);
+#ifdef WIN32
+	_file->header.processId = (unsigned int)GetCurrentProcessId();
+#else
+	_file->header.processId = (unsigned int)getpid();
+#endif
+	atomic_thread_fence(memory_order_release);
+	memcpy(_file->header.magic, OMETRICS_MAGIC, sizeof(_file->header.magic));
+}
+
+OMetricsExporter::~OMetricsExporter()
+{
+	closeFileSink();
+#ifdef WIN32
+	UnmapViewOfFile(_file);
+	CloseHandle(_mappingHandle);
+	CloseHandle(_fileHandle);
+#else
+	munmap(_file, sizeof(OMetricsFile));
+	close(_fd);
+#endif
+}
+
+void OMetricsExporter::addMetric(const char * name, const OStats<int>* stats)
+{
+	addRecord(name, [stats](OMetricsValues* values) { sampleStats(stats, values); });
+}
+
+void OMetricsExporter::addMetric(const char * name, const OStats<float>* stats)
+{
+	addRecord(name, [stats](OMetricsValues* values) { sampleStats(stats, values); });
+}
+
+void OMetricsExporter::addMetric(const char * name, ValueFunction function)
+{
+	addRecord(name, [function](OMetricsValues* values) {
+		float val = (float)function();
+		values->sampleCount = 1;
+		values->last = values->average = values->minValue = values->maxValue = values->p50 = values->p99 = val;
+		values->stdev = 0.0f;
+	});
+}
+
+int OMetricsExporter::metricCount() const
+{
+	return (int)_metrics.size();
+}
+
+void OMetricsExporter::setInterval(int interval_us)
+{
+	_interval_us = interval_us;
+}
+
+int OMetricsExporter::interval() const
+{
+	return _interval_us;
+}
+
+void OMetricsExporter::openFileSink(const char * filename, SinkFormat format)
+{
+	closeFileSink();
+#ifdef WIN32
+	fopen_s(&_sink, filename, "w");
+#else
+	_sink = fopen(filename, "w");
+#endif
+	if (_sink == NULL) throw OException((string("Error opening metrics sink file: '") + filename + "'.").c_str());
+	_sinkFormat = format;
+	_sinkHeaderWritten = false;
+}
+
+void OMetricsExporter::closeFileSink()
+{
+	if (_sink == NULL) return;
+	fclose(_sink);
+	_sink = NULL;
+}
+
+bool OMetricsExporter::update()
+{
+	long long now_ns = OTimeIndex::fromTicks(OTimeIndex::ticks()).toNanoseconds();
+	if (_lastExport_ns > 0 && now_ns - _lastExport_ns < _interval_us * 1000LL) return false;
+	_lastExport_ns = now_ns;
+	exportMetrics();
+	return true;
+}
+
+void OMetricsExporter::exportMetrics()
+{
+	long long timestamp_us = OTimeIndex::fromTicks(OTimeIndex::ticks()).toMicroseconds();
+	vector<OMetricsValues> values(_metrics.size());
+	for (size_t i = 0; i < _metrics.size(); i++) {
+		values[i].timestamp_us = timestamp_us;
+		_metrics[i].sample(&values[i]);
+		OMetricsWriteRecord(&_file->records[i], values[i]);
+	}
+	_file->header.updateCount.fetch_add(1, memory_order_release);
+
+	if (_sink != NULL) writeSink(values, timestamp_us);
+}
+
+long long OMetricsExporter::processMemory()
+{
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+	return (long long)counters.WorkingSetSize;
+#else
+	/* second field of statm: resident set size, in pages */
+	FILE *fp = fopen("/proc/self/statm", "r");
+	if (fp == NULL) return 0;
+	long long size, resident;
+	int count = fscanf(fp, "%lld %lld", &size, &resident);
+	fclose(fp);
+	if (count != 2) return 0;
+	return resident * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+void OMetricsExporter::addRecord(const char * name, const function<void(OMetricsValues*)>& sample)
+{
+	if (_metrics.size() >= OMETRICS_MAXRECORDS) throw OException("Metrics file record capacity exceeded.");
+	if (_sink != NULL && _sinkFormat == CSVSink && _sinkHeaderWritten) {
+		throw OException("Metrics cannot be added to a CSV sink after its header is written.");
+	}
+
+	Metric metric;
+	metric.name = name;
+	metric.sample = sample;
+
+	/* the name is in place before the record is counted */
+	OMetricsRecord *record = &_file->records[_metrics.size()];
+	strncpy(record->name, name, OMETRICS_NAMELENGTH - 1);
+	record->name[OMETRICS_NAMELENGTH - 1] = '\0';
+	_metrics.push_back(metric);
+	_file->header.recordCount.store((unsigned int)_metrics.size(), memory_order_release);
+}
+
+void OMetricsExporter::writeSink(const vector<OMetricsValues>& values, long long timestamp_us)
+{
+	if (_sinkFormat == CSVSink) {
+		if (!_sinkHeaderWritten) {
+			fprintf(_sink, "time_us");
+			for (size_t i = 0; i < _metrics.size(); i++) {
+				fprintf(_sink, ",%s.avg,%s.p99", _metrics[i].name.c_str(), _metrics[i].name.c_str());
+			}
+			fprintf(_sink, "\n");
+		}
+		fprintf(_sink, "%lld", timestamp_us);
+		for (size_t i = 0; i < values.size(); i++) fprintf(_sink, ",%g,%g", values[i].average, values[i].p99);
+		fprintf(_sink, "\n");
+	} else {
+		fprintf(_sink, "{\"time_us\":%lld", timestamp_us);
+		for (size_t i = 0; i < values.size(); i++) {
+			const OMetricsValues& v = values[i];
+			fprintf(_sink, ",\"%s\":{\"n\":%d,\"last\":%g,\"avg\":%g,\"stdev\":%g,\"min\":%g,\"max\":%g,"
+				"\"p50\":%g,\"p99\":%g}", _metrics[i].name.c_str(), v.sampleCount, v.last, v.average, v.stdev,
+				v.minValue, v.maxValue, v.p50, v.p99);
+		}
+		fprintf(_sink, "}\n");
+	}
+	_sinkHeaderWritten = true;
+	fflush(_sink);
+}
@@ -14,6 +14,11 @@ void OObject::scheduleDelete()
 	OApplication::activeInstance()->scheduleDelete(this);
 }
 
+bool OObject::isEventThreadSafe() const
+{
+	return false;
+}
+
 void OObject::processEvent(const OEvent * evt)
 {
 	switch (evt->type()) {
@@ -26,6 +31,11 @@ void OObject::processEvent(const OEvent * evt)
 	}
 }
 
+void OObject::processTimer(int timerId, const OTimeIndex & timeIndex)
+{
+	onTimer(timerId, timeIndex);
+}
+
 void OObject::onKeyboardPress(const OKeyboardPressEvent * evt)
 {
 }
@@ -45,3 +55,7 @@ void OObject::onMouseMove(const OMouseMoveEvent * evt)
 void OObject::onScreenResize(const OResizeEvent * evt)
 {
 }
+
+void OObject::onTimer(int, const OTimeIndex &)
+{
+}
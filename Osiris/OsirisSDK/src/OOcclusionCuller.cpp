@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+#include "OsirisSDK/OMesh.h"
+#include "OsirisSDK/OThreadPool.h"
+#include "OsirisSDK/OOcclusionCuller.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#	define OOCCLUSIONCULLER_SSE
+#	include <xmmintrin.h>
+#endif
+
+/* points closer than this to the camera plane (in clip space w) are not projected */
+#define OOCCLUSIONCULLER_MINW	1e-5f
+
+OOcclusionCuller::OOcclusionCuller(int width, int height) :
+	_width((width + 3) & ~3),
+	_height(height),
+	_depth(_width * _height, FLT_MAX)
+{
+}
+
+OOcclusionCuller::~OOcclusionCuller()
+{
+}
+
+int OOcclusionCuller::width() const
+{
+	return _width;
+}
+
+int OOcclusionCuller::height() const
+{
+	return _height;
+}
+
+void OOcclusionCuller::begin(const OMatrix4x4 & viewProjection)
+{
+	_viewProjection = viewProjection;
+	_triangles.clear();
+	std::fill(_depth.begin(), _depth.end(), FLT_MAX);
+}
+
+void OOcclusionCuller::addOccluder(OMesh * mesh, const OMatrix4x4 & model)
+{
+	OMatrix4x4 mvp = _viewProjection * model;
+	const GLfloat* m = mvp.glArea();
+
+	/* scratch buffers are kept across calls, and only ever grow */
+	size_t vertexCount = (size_t)mesh->vertexCount();
+	if (_screen.size() < vertexCount * 3) _screen.resize(vertexCount * 3);
+	if (_projected.size() < vertexCount) _projected.resize(vertexCount);
+	float* screen = (vertexCount > 0) ? &_screen[0] : NULL;
+	unsigned char* projected = (vertexCount > 0) ? &_projected[0] : NULL;
+	for (int i = 0; i < mesh->vertexCount(); i++) {
+		OVector3 v = mesh->vertexData(i);
+		projected[i] = (project(m, v.x(), v.y(), v.z(), &screen[i * 3])) ? 1 : 0;
+	}
+
+	for (int f = 0; f < mesh->faceCount(); f++) {
+		OVector3 face = mesh->indexData(f);
+		int idx[3] = { (int)face.x(), (int)face.y(), (int)face.z() };
+
+		/* triangles that cross the camera plane are left out, instead of clipped: occluders only need to be
+		   conservative */
+		if (!projected[idx[0]] || !projected[idx[1]] || !projected[idx[2]]) continue;
+
+		float x[3], y[3], z[3];
+		for (int k = 0; k < 3; k++) {
+			x[k] = screen[idx[k] * 3];
+			y[k] = screen[idx[k] * 3 + 1];
+			z[k] = screen[idx[k] * 3 + 2];
+		}
+
+		/* both windings are accepted, so that occluders don't depend on face culling */
+		float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+		if (fabsf(area) < 1e-8f) continue;
+		if (area < 0.0f) {
+			float t;
+			t = x[1]; x[1] = x[2]; x[2] = t;
+			t = y[1]; y[1] = y[2]; y[2] = t;
+			t = z[1]; z[1] = z[2]; z[2] = t;
+			area = -area;
+		}
+
+		Triangle tri;
+		float minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+		for (int k = 1; k < 3; k++) {
+			if (x[k] < minX) minX = x[k];
+			if (x[k] > maxX) maxX = x[k];
+			if (y[k] < minY) minY = y[k];
+			if (y[k] > maxY) maxY = y[k];
+		}
+		tri.minX = (minX < 0.0f) ? 0 : (int)minX;
+		tri.maxX = (maxX > _width - 1.0f) ? _width - 1 : (int)maxX;
+		tri.minY = (minY < 0.0f) ? 0 : (int)minY;
+		tri.maxY = (maxY > _height - 1.0f) ? _height - 1 : (int)maxY;
+		if (tri.minX > tri.maxX || tri.minY > tri.maxY) continue;
+
+		/* edge k goes from vertex k to vertex k + 1, and is positive on the inner side */
+		for (int k = 0; k < 3; k++) {
+			int n = (k + 1) % 3;
+			tri.edgeA[k] = y[k] - y[n];
+			tri.edgeB[k] = x[n] - x[k];
+			tri.edgeC[k] = x[k] * y[n] - x[n] * y[k];
+		}
+
+		float dx1 = x[1] - x[0], dy1 = y[1] - y[0], dz1 = z[1] - z[0];
+		float dx2 = x[2] - x[0], dy2 = y[2] - y[0], dz2 = z[2] - z[0];
+		tri.depthA = (dz1 * dy2 - dz2 * dy1) / area;
+		tri.depthB = (dx1 * dz2 - dx2 * dz1) / area;
+		tri.depthC = z[0] - tri.depthA * x[0] - tri.depthB * y[0];
+
+		_triangles.push_back(tri);
+	}
+}
+
+void OOcclusionCuller::rasterize(OThreadPool * pool)
+{
+	int bands = (_height + OOCCLUSIONCULLER_BANDHEIGHT - 1) / OOCCLUSIONCULLER_BANDHEIGHT;
+	OThreadPool::Task task = [this](int begin, int end) {
+		int rowEnd = end * OOCCLUSIONCULLER_BANDHEIGHT;
+		rasterizeBand(begin * OOCCLUSIONCULLER_BANDHEIGHT, (rowEnd > _height) ? _height : rowEnd);
+	};
+
+	/* bands don't share rows, so they are rasterized without locking */
+	if (pool != NULL) pool->parallelFor(bands, 1, task);
+	else task(0, bands);
+}
+
+void OOcclusionCuller::rasterizeBand(int rowBegin, int rowEnd)
+{
+	for (std::vector<Triangle>::const_iterator it = _triangles.begin(); it != _triangles.end(); it++) {
+		const Triangle& tri = *it;
+		int y0 = (tri.minY > rowBegin) ? tri.minY : rowBegin;
+		int y1 = (tri.maxY < rowEnd - 1) ? tri.maxY : rowEnd - 1;
+		int x0 = tri.minX & ~3;
+
+		for (int py = y0; py <= y1; py++) {
+			float cy = py + 0.5f;
+			float* row = &_depth[py * _width];
+			int px = x0;
+
+#ifdef OOCCLUSIONCULLER_SSE
+			/* four pixels at a time, from a multiple of four: rows never end in the middle of a group */
+			__m128 zero = _mm_setzero_ps();
+			__m128 step = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+			__m128 e0a = _mm_set1_ps(tri.edgeA[0]), e1a = _mm_set1_ps(tri.edgeA[1]), e2a = _mm_set1_ps(tri.edgeA[2]);
+			__m128 e0 = _mm_set1_ps(tri.edgeB[0] * cy + tri.edgeC[0]);
+			__m128 e1 = _mm_set1_ps(tri.edgeB[1] * cy + tri.edgeC[1]);
+			__m128 e2 = _mm_set1_ps(tri.edgeB[2] * cy + tri.edgeC[2]);
+			__m128 da = _mm_set1_ps(tri.depthA);
+			__m128 d = _mm_set1_ps(tri.depthB * cy + tri.depthC);
+			for (; px <= tri.maxX; px += 4) {
+				__m128 cx = _mm_add_ps(_mm_set1_ps((float)px), step);
+				__m128 inside = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(e0a, cx), e0), zero),
+							   _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(e1a, cx), e1), zero));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(e2a, cx), e2), zero));
+				if (_mm_movemask_ps(inside) == 0) continue;
+
+				__m128 depth = _mm_loadu_ps(row + px);
+				__m128 z = _mm_min_ps(depth, _mm_add_ps(_mm_mul_ps(da, cx), d));
+				_mm_storeu_ps(row + px, _mm_or_ps(_mm_and_ps(inside, z), _mm_andnot_ps(inside, depth)));
+			}
+#endif
+
+			/* remaining pixels (or all of them, without SSE) */
+			for (; px <= tri.maxX; px++) {
+				float cx = px + 0.5f;
+				bool inside = true;
+				for (int k = 0; k < 3 && inside; k++) {
+					if (tri.edgeA[k] * cx + tri.edgeB[k] * cy + tri.edgeC[k] < 0.0f) inside = false;
+				}
+				if (!inside) continue;
+				float z = tri.depthA * cx + tri.depthB * cy + tri.depthC;
+				if (z < row[px]) row[px] = z;
+			}
+		}
+	}
+}
+
+bool OOcclusionCuller::isOccluded(const OVector3 & center, float radius) const
+{
+	/* screen rectangle and nearest depth of the sphere bounding box */
+	const GLfloat* m = _viewProjection.glArea();
+	float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX;
+	for (int i = 0; i < 8; i++) {
+		float p[3];
+		if (!project(m, center.x() + ((i & 1) ? radius : -radius), center.y() + ((i & 2) ? radius : -radius),
+			     center.z() + ((i & 4) ? radius : -radius), p)) return false;
+		if (p[0] < minX) minX = p[0];
+		if (p[0] > maxX) maxX = p[0];
+		if (p[1] < minY) minY = p[1];
+		if (p[1] > maxY) maxY = p[1];
+		if (p[2] < minZ) minZ = p[2];
+	}
+
+	/* objects off the screen are left to frustum culling */
+	if (maxX < 0.0f || maxY < 0.0f || minX >= _width || minY >= _height) return false;
+	int x0 = (minX < 0.0f) ? 0 : (int)minX;
+	int x1 = (maxX > _width - 1.0f) ? _width - 1 : (int)maxX;
+	int y0 = (minY < 0.0f) ? 0 : (int)minY;
+	int y1 = (maxY > _height - 1.0f) ? _height - 1 : (int)maxY;
+
+	for (int py = y0; py <= y1; py++) {
+		const float* row = &_depth[py * _width];
+		int px = x0;
+
+#ifdef OOCCLUSIONCULLER_SSE
+		__m128 z = _mm_set1_ps(minZ);
+		for (; px + 4 <= x1 + 1; px += 4) {
+			if (_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(row + px), z)) != 0xf) return false;
+		}
+#endif
+
+		for (; px <= x1; px++) {
+			if (!(row[px] < minZ)) return false;
+		}
+	}
+
+	return true;
+}
+
+int OOcclusionCuller::triangleCount() const
+{
+	return (int)_triangles.size();
+}
+
+const float * OOcclusionCuller::depthBuffer() const
+{
+	return &_depth[0];
+}
+
+bool OOcclusionCuller::project(const GLfloat * mtx, float x, float y, float z, float * out) const
+{
+	/* column-major matrix */
+	float w = mtx[3] * x + mtx[7] * y + mtx[11] * z + mtx[15];
+	if (w < OOCCLUSIONCULLER_MINW) return false;
+	float cx = mtx[0] * x + mtx[4] * y + mtx[8] * z + mtx[12];
+	float cy = mtx[1] * x + mtx[5] * y + mtx[9] * z + mtx[13];
+	float cz = mtx[2] * x + mtx[6] * y + mtx[10] * z + mtx[14];
+	out[0] = (cx / w * 0.5f + 0.5f) * _width;
+	out[1] = (cy / w * 0.5f + 0.5f) * _height;
+	out[2] = cz / w;
+	return true;
+}
+
@@ -3,162 +3,76 @@
 
 #include "OsirisSDK/OParameterList.h"
 
-
-// ****************************************************************************
-// OParameterList
-// ****************************************************************************
-OParameterList::OParameterList(int count) : 
-	_attrCount(count)
+OParameterList::OParameterList(const OParameterSchema* schema) :
+	_schema(schema),
+	_slots(NULL)
 {
-	if (count > 0) _attrs = new Parameter[count];
-	else _attrs = NULL;
+	if (_schema == NULL) throw OException("Parameter list created without a schema.");
+	if (_schema->count() > 0) {
+		_slots = new OParameterSchema::Slot[_schema->count()];
+		memcpy(_slots, _schema->defaults(), _schema->count() * sizeof(OParameterSchema::Slot));
+	}
 }
 
 OParameterList::~OParameterList()
 {
-	delete[] _attrs;
-}
-
-int OParameterList::count() const
-{
-	return _attrCount;
-}
-
-OParameterList::Parameter & OParameterList::get(int idx)
-{
-	if (idx >= _attrCount) throw OException("Invalid access to parameter list.");
-	return _attrs[idx];
-}
-
-OParameterList::Parameter & OParameterList::operator[](int idx)
-{
-	return get(idx);
-}
-
-// ****************************************************************************
-// OParameterList::Parameter
-// ****************************************************************************
-OParameterList::Parameter::Parameter() : _type(Uninitialized)
-{
-}
-
-OParameterList::Parameter::Parameter(const Parameter & in) :
-	_type(in._type),
-	_value(in._value)
-{
-}
-
-OParameterList::Parameter::Parameter(bool val) :
-	_type(Boolean)
-{
-	_value._bool = val;
-}
-
-OParameterList::Parameter::Parameter(int val) :
-	_type(Integer)
-{
-	_value._int = val;
+	delete[] _slots;
 }
 
-OParameterList::Parameter::Parameter(float val) :
-	_type(Float)
+const OParameterSchema * OParameterList::schema() const
 {
-	_value._float = val;
+	return _schema;
 }
 
-OParameterList::Parameter::Parameter(const char * val) :
-	_type(String)
-{
-	_value._str = _strdup(val);
-}
-
-OParameterList::Parameter::~Parameter()
-{
-	if (_type == String && _value._str != NULL) delete _value._str;
-}
-
-OParameterList::Parameter::Type OParameterList::Parameter::type() const
-{
-	return _type;
-}
-
-bool OParameterList::Parameter::boolVal() const
-{
-	if (_type != Uninitialized && _type != Boolean) throw OException("Parameter type mismatch.");
-	return _value._bool;
-}
-
-int OParameterList::Parameter::intVal() const
-{
-	if (_type != Uninitialized && _type != Integer) throw OException("Parameter type mismatch.");
-	return _value._int;
-}
-
-float OParameterList::Parameter::floatVal() const
-{
-	if (_type != Uninitialized && _type != Float) throw OException("Parameter type mismatch.");
-	return _value._float;
-}
-
-const char * OParameterList::Parameter::strVal() const
-{
-	if (_type != Uninitialized && _type != String) throw OException("Parameter type mismatch.");
-	return _value._str;
-}
-
-void OParameterList::Parameter::setVal(bool val)
+int OParameterList::count() const
 {
-	if (_type != Uninitialized && _type != Boolean) throw OException("Parameter type mismatch.");
-	_value._bool = val;
+	return _schema->count();
 }
 
-void OParameterList::Parameter::setVal(int val)
+bool OParameterList::boolVal(int idx) const
 {
-	if (_type != Uninitialized && _type != Integer) throw OException("Parameter type mismatch.");
-	_value._int = val;
+	_schema->check(idx, OParameterSchema::Boolean);
+	return _slots[idx].boolVal;
 }
 
-void OParameterList::Parameter::setVal(float val)
+int OParameterList::intVal(int idx) const
 {
-	if (_type != Uninitialized && _type != Float) throw OException("Parameter type mismatch.");
-	_value._float = val;
+	_schema->check(idx, OParameterSchema::Integer);
+	return _slots[idx].intVal;
 }
 
-void OParameterList::Parameter::setVal(const char * val)
+float OParameterList::floatVal(int idx) const
 {
-	if (_type != Uninitialized && _type != String) throw OException("Parameter type mismatch.");
-	if (_value._str != NULL) free(_value._str);
-	_value._str = _strdup(val);
+	_schema->check(idx, OParameterSchema::Float);
+	return _slots[idx].floatVal;
 }
 
-OParameterList::Parameter & OParameterList::Parameter::operator=(const Parameter & in)
+const char * OParameterList::strVal(int idx) const
 {
-	if (_type == Uninitialized) _type = in._type;
-	else if (_type != in._type) throw OException("Parameter type mismatch.");
-	_value = in._value;
-	return *this;
+	_schema->check(idx, OParameterSchema::String);
+	return _slots[idx].strVal;
 }
 
-OParameterList::Parameter & OParameterList::Parameter::operator=(bool in)
+void OParameterList::setVal(int idx, bool val)
 {
-	setVal(in);
-	return *this;
+	_schema->check(idx, OParameterSchema::Boolean);
+	_slots[idx].boolVal = val;
 }
 
-OParameterList::Parameter & OParameterList::Parameter::operator=(int in)
+void OParameterList::setVal(int idx, int val)
 {
-	setVal(in);
-	return *this;
+	_schema->check(idx, OParameterSchema::Integer);
+	_slots[idx].intVal = val;
 }
 
-OParameterList::Parameter & OParameterList::Parameter::operator=(float in)
+void OParameterList::setVal(int idx, float val)
 {
-	setVal(in);
-	return *this;
+	_schema->check(idx, OParameterSchema::Float);
+	_slots[idx].floatVal = val;
 }
 
-OParameterList::Parameter & OParameterList::Parameter::operator=(const char * in)
+void OParameterList::setVal(int idx, const char * val)
 {
-	setVal(in);
-	return *this;
+	_schema->check(idx, OParameterSchema::String);
+	_slots[idx].strVal = OParameterSchema::intern(val);
 }
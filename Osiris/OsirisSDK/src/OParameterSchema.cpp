@@ -0,0 +1,92 @@
+#include <sstream>
+
+#include "OsirisSDK/OException.h"
+
+#include "OsirisSDK/OParameterSchema.h"
+
+using namespace std;
+
+mutex OParameterSchema::_internMutex;
+set<string> OParameterSchema::_internSet;
+
+OParameterSchema::OParameterSchema(const char * name) :
+	_name(name)
+{
+}
+
+OParameterSchema::~OParameterSchema()
+{
+}
+
+const char * OParameterSchema::name() const
+{
+	return _name.c_str();
+}
+
+int OParameterSchema::count() const
+{
+	return (int)_types.size();
+}
+
+OParameterSchema::Type OParameterSchema::type(int idx) const
+{
+	if (idx < 0 || idx >= count()) return Uninitialized;
+	return _types[idx];
+}
+
+void OParameterSchema::define(int idx, bool defaultValue)
+{
+	define(idx, Boolean).boolVal = defaultValue;
+}
+
+void OParameterSchema::define(int idx, int defaultValue)
+{
+	define(idx, Integer).intVal = defaultValue;
+}
+
+void OParameterSchema::define(int idx, float defaultValue)
+{
+	define(idx, Float).floatVal = defaultValue;
+}
+
+void OParameterSchema::define(int idx, const char * defaultValue)
+{
+	define(idx, String).strVal = intern(defaultValue);
+}
+
+const OParameterSchema::Slot * OParameterSchema::defaults() const
+{
+	return (_defaults.size() > 0) ? &_defaults[0] : NULL;
+}
+
+void OParameterSchema::check(int idx, Type type) const
+{
+	if (this->type(idx) != type) {
+		stringstream ss;
+		ss << "Parameter type mismatch on schema '" << _name << "', index " << idx << ".";
+		throw OException(ss.str().c_str());
+	}
+}
+
+const char * OParameterSchema::intern(const char * str)
+{
+	if (str == NULL) str = "";
+
+	/* set nodes are never moved or removed, so their storage can be referenced directly */
+	lock_guard<mutex> lock(_internMutex);
+	return _internSet.insert(string(str)).first->c_str();
+}
+
+OParameterSchema::Slot & OParameterSchema::define(int idx, Type type)
+{
+	if (idx < 0) throw OException("Invalid parameter index.");
+	if (idx >= count()) {
+		Slot empty;
+		empty.intVal = 0;
+		_types.resize(idx + 1, Uninitialized);
+		_defaults.resize(idx + 1, empty);
+	}
+	if (_types[idx] != Uninitialized && _types[idx] != type) check(idx, type);
+	_types[idx] = type;
+	return _defaults[idx];
+}
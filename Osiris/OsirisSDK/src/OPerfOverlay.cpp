@@ -0,0 +1,256 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "OsirisSDK/OApplication.h"
+#include "OsirisSDK/OSimulation.h"
+#include "OsirisSDK/OText2D.h"
+#include "OsirisSDK/OGPUTimer.h"
+#include "OsirisSDK/OGLState.h"
+#include "OsirisSDK/OProfiler.h"
+#include "OsirisSDK/OTimeIndex.h"
+
+#include "OsirisSDK/OPerfOverlay.h"
+
+#include "resource.h"
+
+using namespace std;
+
+OShaderProgram* OPerfOverlay::_shaderProgram = NULL;
+
+const float OPerfOverlay::_stripColors[OPerfOverlay::StripCount][4] = {
+	{ 0.0f, 1.0f, 0.0f, 1.0f },	/* frame time */
+	{ 1.0f, 1.0f, 0.0f, 1.0f },	/* simulation time */
+	{ 0.0f, 0.6f, 1.0f, 1.0f },	/* render time */
+	{ 1.0f, 0.0f, 0.0f, 0.6f },	/* frame budget */
+	{ 0.5f, 0.5f, 0.5f, 0.6f }	/* area frame */
+};
+
+OPerfOverlay::OPerfOverlay(OApplication * app, OFont * font, unsigned int fontSize) :
+	_app(app),
+	_text(NULL),
+	_x(-0.98f),
+	_y(-0.98f),
+	_width(0.6f),
+	_height(0.3f),
+	_scale_us(OPERFOVERLAY_DEFAULT_SCALE_US),
+	_historyHead(0),
+	_costStats(OPERFOVERLAY_HISTORY),
+	_lastTextUpdate_ns(0),
+	_eventCount(0)
+{
+	_Init();
+
+	memset(_history, 0, sizeof(_history));
+	_text = new OText2D(font, fontSize, -0.98f, 0.95f, OVector4(0.0f, 1.0f, 0.0f, 1.0f));
+
+	/* vertex ranges of each line strip */
+	int first = 0;
+	for (int i = 0; i < StripCount; i++) {
+		_stripFirst[i] = first;
+		if (i < GraphCount) _stripCount[i] = OPERFOVERLAY_HISTORY;
+		else if (i == BudgetLine) _stripCount[i] = 2;
+		else _stripCount[i] = 5;
+		first += _stripCount[i];
+	}
+	_vertices.resize(first);
+
+	/* vertex buffer: position (x, y) and color (r, g, b, a) */
+	glGenVertexArrays(1, &_arrayObject);
+	glGenBuffers(1, &_vertexBuffer);
+	OGLState::bindVertexArray(_arrayObject);
+	OGLState::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, _vertices.size() * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(2 * sizeof(float)));
+	OGLState::bindVertexArray(0);
+}
+
+OPerfOverlay::~OPerfOverlay()
+{
+	delete _text;
+	OGLState::deleteBuffers(1, &_vertexBuffer);
+	OGLState::deleteVertexArrays(1, &_arrayObject);
+}
+
+void OPerfOverlay::setGraphArea(float x, float y, float width, float height)
+{
+	_x = x;
+	_y = y;
+	_width = width;
+	_height = height;
+}
+
+void OPerfOverlay::setTextPosition(float x, float y)
+{
+	_text->setPosition(x, y);
+}
+
+void OPerfOverlay::setScale(int scale_us)
+{
+	_scale_us = scale_us;
+}
+
+int OPerfOverlay::scale() const
+{
+	return _scale_us;
+}
+
+const OStats<float>& OPerfOverlay::costStats() const
+{
+	return _costStats;
+}
+
+void OPerfOverlay::render(OMatrixStack *)
+{
+	if (isHidden()) return;
+	OPROFILE_ZONE("OPerfOverlay::render");
+	OGPUTIMER_SCOPE("OPerfOverlay");
+	long long start = OTimeIndex::ticks();
+
+	sample();
+	updateVertices();
+
+	/* the overlay is drawn over the scene */
+	bool depthTest = OGLState::isEnabled(GL_DEPTH_TEST);
+	OGLState::disable(GL_DEPTH_TEST);
+
+	/* graphs: the previous buffer storage is orphaned, so that the upload does not wait for the GPU to
+	   finish reading it */
+	GLsizeiptr size = _vertices.size() * sizeof(Vertex);
+	OGLState::bindVertexArray(_arrayObject);
+	OGLState::bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, &_vertices[0]);
+	_shaderProgram->use();
+	glMultiDrawArrays(GL_LINE_STRIP, _stripFirst, _stripCount, StripCount);
+
+	/* text readout */
+	long long now_ns = OTimeIndex::fromTicks(start).toNanoseconds();
+	if (now_ns - _lastTextUpdate_ns >= OPERFOVERLAY_TEXTINTERVAL_US * 1000LL) updateText(now_ns);
+	_text->render();
+
+	if (depthTest) OGLState::enable(GL_DEPTH_TEST);
+
+	_costStats.add(OTimeIndex::ticksToNanoseconds(OTimeIndex::ticks() - start) / 1000.0f);
+}
+
+void OPerfOverlay::sample()
+{
+	_historyHead = (_historyHead + 1) % OPERFOVERLAY_HISTORY;
+	_history[FrameTimeGraph][_historyHead] = _app->framePacer().frameTimeStats().last();
+	_history[SimulationTimeGraph][_historyHead] = _app->simulationTimeStats().last();
+	_history[RenderTimeGraph][_historyHead] = _app->renderTimeStats().last();
+	_eventCount += _app->deliveredEventCount();
+}
+
+void OPerfOverlay::updateVertices()
+{
+	/* graphs, oldest sample on the left */
+	float dx = _width / (OPERFOVERLAY_HISTORY - 1);
+	for (int g = 0; g < GraphCount; g++) {
+		for (int i = 0; i < OPERFOVERLAY_HISTORY; i++) {
+			float h = (float)_history[g][(_historyHead + 1 + i) % OPERFOVERLAY_HISTORY] / _scale_us;
+			if (h < 0.0f) h = 0.0f;
+			else if (h > 1.0f) h = 1.0f;
+			setVertex(_stripFirst[g] + i, _x + i * dx, _y + h * _height, _stripColors[g]);
+		}
+	}
+
+	/* frame budget */
+	int budget_us = (_app->targetFPS() > 0) ? 1000000 / _app->targetFPS() : OPERFOVERLAY_DEFAULT_BUDGET_US;
+	float budgetY = _y + ((budget_us < _scale_us) ? (float)budget_us / _scale_us : 1.0f) * _height;
+	setVertex(_stripFirst[BudgetLine], _x, budgetY, _stripColors[BudgetLine]);
+	setVertex(_stripFirst[BudgetLine] + 1, _x + _width, budgetY, _stripColors[BudgetLine]);
+
+	/* area frame */
+	setVertex(_stripFirst[Frame], _x, _y, _stripColors[Frame]);
+	setVertex(_stripFirst[Frame] + 1, _x + _width, _y, _stripColors[Frame]);
+	setVertex(_stripFirst[Frame] + 2, _x + _width, _y + _height, _stripColors[Frame]);
+	setVertex(_stripFirst[Frame] + 3, _x, _y + _height, _stripColors[Frame]);
+	setVertex(_stripFirst[Frame] + 4, _x, _y, _stripColors[Frame]);
+}
+
+void OPerfOverlay::updateText(long long now_ns)
+{
+	char buff[512];
+	int len;
+
+	/* event rate since the last update */
+	float elapsed_s = (_lastTextUpdate_ns > 0) ? (now_ns - _lastTextUpdate_ns) / 1e9f : 0.0f;
+	float eventRate = (elapsed_s > 0.0f) ? _eventCount / elapsed_s : 0.0f;
+	_eventCount = 0;
+	_lastTextUpdate_ns = now_ns;
+
+	const OStats<int>& frameTime = _app->framePacer().frameTimeStats();
+	len = snprintf(buff, sizeof(buff),
+		       "%.1f fps (1%% low: %.1f)\n"
+		       "Frame: %.2f ms (p99: %.2f ms, jitter: %.2f ms)\n"
+		       "Simulation: %.2f ms (perf coef: %.3f)\n"
+		       "Render: %.2f ms (p99: %.2f ms)\n"
+		       "%.0f events/s",
+		       _app->fpsStats().average(), _app->fpsStats().percentile(1),
+		       frameTime.average() / 1000.0f, frameTime.percentile(99) / 1000.0f,
+		       _app->framePacer().jitterStats().average() / 1000.0f,
+		       _app->simulationTimeStats().average() / 1000.0f, _app->performanceStats().average(),
+		       _app->renderTimeStats().average() / 1000.0f, _app->renderTimeStats().percentile(99) / 1000.0f,
+		       eventRate);
+
+	/* counters only available on some configurations */
+	OSimulation *sim = dynamic_cast<OSimulation*>(_app);
+	if (sim != NULL && len < (int)sizeof(buff)) {
+		len += snprintf(buff + len, sizeof(buff) - len, ", %d entities (%d culled)", (int)sim->entities()->count(),
+				sim->culledCount());
+	}
+	if (sim != NULL && sim->occlusionCulling() && len < (int)sizeof(buff)) {
+		len += snprintf(buff + len, sizeof(buff) - len, ", %d occluded (%.0f%%)", sim->occludedCount(),
+				sim->occlusionRejectionRate() * 100.0f);
+	}
+	if (OGLCounters::enabled() && len < (int)sizeof(buff)) {
+		len += snprintf(buff + len, sizeof(buff) - len, ", %d draws",
+				OGLCounters::frameCount(OGLCounters::DrawCalls));
+	}
+	if (len < (int)sizeof(buff)) {
+		len += snprintf(buff + len, sizeof(buff) - len, ", %d/%d GL state calls skipped",
+				OGLState::frameSkipped(), OGLState::frameIssued() + OGLState::frameSkipped());
+	}
+	if (OGPUTimer::enabled() && len < (int)sizeof(buff)) {
+		static const char* passNames[] = { "ORenderQueue::opaque", "ORenderQueue::blended", "ORenderQueue::overlay" };
+		float gpu_us = 0.0f;
+		for (int i = 0; i < 3; i++) {
+			const OStats<float>* passGPU = OGPUTimer::passStats(passNames[i]);
+			if (passGPU != NULL) gpu_us += passGPU->average();
+		}
+		len += snprintf(buff + len, sizeof(buff) - len, "\nGPU: %.2f ms", gpu_us / 1000.0f);
+	}
+	if (len < (int)sizeof(buff)) {
+		snprintf(buff + len, sizeof(buff) - len, "\nOverlay: %.3f ms", _costStats.average() / 1000.0f);
+	}
+
+	_text->setContent(buff);
+}
+
+void OPerfOverlay::setVertex(int idx, float x, float y, const float * color)
+{
+	Vertex& v = _vertices[idx];
+	v.x = x;
+	v.y = y;
+	memcpy(v.color, color, sizeof(v.color));
+}
+
+void OPerfOverlay::_Init()
+{
+	if (_shaderProgram == NULL) {
+		_shaderProgram = new OShaderProgram("OPerfOverlayRenderer");
+#ifdef WIN32
+		_shaderProgram->addShader(OShaderObject::ShaderType_Vertex, "Vertex-OPerfOverlay", 
+					  IDR_SHADER_VERTEX_OPERFOVERLAY);
+		_shaderProgram->addShader(OShaderObject::ShaderType_Fragment, "Fragment-StandardColor",
+					  IDR_SHADER_FRAGMENT_STANDARDCOLOR);
+#else
+#error Embedded shader is not yet implemented for non-Windows platforms.
+#endif
+		_shaderProgram->compile();
+	}
+}
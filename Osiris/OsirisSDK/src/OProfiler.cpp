@@ -0,0 +1,106 @@
+#include <stdio.h>
+
+#include "OsirisSDK/OTimeIndex.h"
+
+#include "OsirisSDK/OProfiler.h"
+
+using namespace std;
+
+// ***********************************************************************
+// OProfiler
+// ***********************************************************************
+mutex OProfiler::_buffersMutex;
+vector<OProfiler::ThreadBuffer*> OProfiler::_buffers;
+
+void OProfiler::record(const char * name, long long start_us, long long end_us)
+{
+	ThreadBuffer *buffer = threadBuffer();
+	unsigned long long head = buffer->head.load(memory_order_relaxed);
+	Zone& zone = buffer->zones[head % OPROFILER_BUFFERSIZE];
+	zone.name = name;
+	zone.start_us = start_us;
+	zone.end_us = end_us;
+	buffer->head.store(head + 1, memory_order_release);
+}
+
+void OProfiler::clear()
+{
+	/* buffers are never released, since threads keep pointers to them, and the write position is only
+	   changed by the owner thread: clearing just moves the start of the exported range */
+	lock_guard<mutex> lock(_buffersMutex);
+	for (size_t i = 0; i < _buffers.size(); i++) _buffers[i]->base.store(_buffers[i]->head.load());
+}
+
+bool OProfiler::exportChromeTrace(const char * filename)
+{
+	FILE *fp;
+#ifdef WIN32
+	fopen_s(&fp, filename, "wb");
+#else
+	fp = fopen(filename, "wb");
+#endif
+	if (!fp) return false;
+
+	lock_guard<mutex> lock(_buffersMutex);
+	vector<Zone> zones;
+	bool first = true;
+	fprintf(fp, "{\"traceEvents\":[\n");
+	for (size_t i = 0; i < _buffers.size(); i++) {
+		ThreadBuffer *buffer = _buffers[i];
+
+		/* copying while the owner thread may still be writing: entries that may have been overwritten
+		   during the copy are discarded */
+		unsigned long long head = buffer->head.load(memory_order_acquire);
+		unsigned long long tail = (head > OPROFILER_BUFFERSIZE) ? head - OPROFILER_BUFFERSIZE : 0;
+		if (tail < buffer->base.load()) tail = buffer->base.load();
+		zones.clear();
+		for (unsigned long long j = tail; j < head; j++) zones.push_back(buffer->zones[j % OPROFILER_BUFFERSIZE]);
+		unsigned long long newHead = buffer->head.load(memory_order_acquire);
+		size_t skip = 0;
+		if (newHead > OPROFILER_BUFFERSIZE && newHead - OPROFILER_BUFFERSIZE > tail) {
+			skip = (size_t)(newHead - OPROFILER_BUFFERSIZE - tail);
+		}
+
+		for (size_t j = skip; j < zones.size(); j++) {
+			fprintf(fp, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d}",
+				(first) ? "" : ",\n", zones[j].name, zones[j].start_us, zones[j].end_us - zones[j].start_us,
+				buffer->threadId);
+			first = false;
+		}
+	}
+	fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+	bool ok = (ferror(fp) == 0);
+	fclose(fp);
+	return ok;
+}
+
+OProfiler::ThreadBuffer * OProfiler::threadBuffer()
+{
+	thread_local ThreadBuffer *buffer = NULL;
+	if (buffer == NULL) {
+		lock_guard<mutex> lock(_buffersMutex);
+		buffer = new ThreadBuffer;
+		buffer->threadId = (int)_buffers.size() + 1;
+		buffer->head.store(0);
+		buffer->base.store(0);
+		_buffers.push_back(buffer);
+	}
+	return buffer;
+}
+
+// ***********************************************************************
+// OProfileZone
+// ***********************************************************************
+OProfileZone::OProfileZone(const char * name) :
+	_name(name),
+	_startTicks(OTimeIndex::ticks())
+{
+}
+
+OProfileZone::~OProfileZone()
+{
+	long long endTicks = OTimeIndex::ticks();
+	OProfiler::record(_name, OTimeIndex::fromTicks(_startTicks).toMicroseconds(),
+			  OTimeIndex::fromTicks(endTicks).toMicroseconds());
+}
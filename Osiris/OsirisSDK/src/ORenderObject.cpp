@@ -1,6 +1,6 @@
+#include "OsirisSDK/OMatrixStack.h"
 #include "OsirisSDK/ORenderObject.h"
 
-
 ORenderObject::ORenderObject() :
 	_hidden(false)
 {
@@ -12,15 +12,41 @@ ORenderObject::~ORenderObject()
 
 void ORenderObject::show()
 {
+	if (!_hidden) return;
 	_hidden = false;
+	onVisibilityChange();
 }
 
 void ORenderObject::hide()
 {
+	if (_hidden) return;
 	_hidden = true;
+	onVisibilityChange();
 }
 
 bool ORenderObject::isHidden() const
 {
 	return _hidden;
 }
+
+void ORenderObject::onVisibilityChange()
+{
+}
+
+void ORenderObject::submit(ORenderQueue * queue, OMatrixStack * stack)
+{
+	if (isHidden()) return;
+	queue->submit(this, stack->top(), ORenderQueue::Pass_Overlay);
+}
+
+void ORenderObject::renderItem(const ORenderQueue::Item & item, bool)
+{
+	OMatrixStack stack;
+	stack *= item.transform;
+	render(&stack);
+}
+
+bool ORenderObject::boundingSphere(OVector3 &, float &)
+{
+	return false;
+}
@@ -0,0 +1,174 @@
+#include <string.h>
+
+#include "OsirisSDK/GLdefs.h"
+#include "OsirisSDK/ORenderObject.h"
+#include "OsirisSDK/OProfiler.h"
+#include "OsirisSDK/OGPUTimer.h"
+#include "OsirisSDK/OGLState.h"
+
+#include "OsirisSDK/ORenderQueue.h"
+
+using namespace std;
+
+/* the bit pattern of non-negative floats sorts the same way as their values */
+static unsigned int depthBits(float depth)
+{
+	if (!(depth > 0.0f)) return 0;
+	unsigned int bits;
+	memcpy(&bits, &depth, sizeof(bits));
+	return bits;
+}
+
+ORenderQueue::ORenderQueue() :
+	_viewProjection(1.0f),
+	_stateChanges(0)
+{
+}
+
+ORenderQueue::~ORenderQueue()
+{
+}
+
+void ORenderQueue::submit(ORenderObject * object, const OMatrix4x4 & transform, Pass pass, unsigned int program,
+			  unsigned int mesh, float depth, const float * instanceMtx, int instanceCount)
+{
+	Entry entry;
+	entry.key = sortKey(pass, program, mesh, depth, (unsigned int)_items.size());
+	entry.index = (int)_items.size();
+	_order.push_back(entry);
+
+	Item item;
+	item.key = entry.key;
+	item.pass = pass;
+	item.program = program;
+	item.mesh = mesh;
+	item.object = object;
+	item.transform = transform;
+	item.instanceMtx = instanceMtx;
+	item.instanceCount = instanceCount;
+	_items.push_back(item);
+}
+
+void ORenderQueue::setViewProjection(const OMatrix4x4 & viewProjection)
+{
+	_viewProjection = viewProjection;
+}
+
+const OMatrix4x4 & ORenderQueue::viewProjection() const
+{
+	return _viewProjection;
+}
+
+void ORenderQueue::clear()
+{
+	_items.clear();
+	_order.clear();
+}
+
+int ORenderQueue::itemCount() const
+{
+	return (int)_items.size();
+}
+
+void ORenderQueue::sort()
+{
+	OPROFILE_ZONE("ORenderQueue::sort");
+
+	size_t n = _order.size();
+	if (n < 2) return;
+	_scratch.resize(n);
+
+	/* LSD radix sort, one byte per pass: being stable, each pass keeps the order set by the previous ones */
+	for (int shift = 0; shift < 64; shift += 8) {
+		size_t count[256];
+		memset(count, 0, sizeof(count));
+		for (size_t i = 0; i < n; i++) count[(_order[i].key >> shift) & 0xff]++;
+
+		/* all items share this byte */
+		if (count[(_order[0].key >> shift) & 0xff] == n) continue;
+
+		size_t offset = 0;
+		for (int b = 0; b < 256; b++) {
+			size_t c = count[b];
+			count[b] = offset;
+			offset += c;
+		}
+		for (size_t i = 0; i < n; i++) _scratch[count[(_order[i].key >> shift) & 0xff]++] = _order[i];
+		_order.swap(_scratch);
+	}
+}
+
+void ORenderQueue::execute()
+{
+	OPROFILE_ZONE("ORenderQueue::execute");
+	static const int gpuPass[PassCount] = {
+		OGPUTimer::pass("ORenderQueue::opaque"),
+		OGPUTimer::pass("ORenderQueue::blended"),
+		OGPUTimer::pass("ORenderQueue::overlay")
+	};
+
+	_stateChanges = 0;
+	size_t i = 0;
+	while (i < _order.size()) {
+		Pass pass = _items[_order[i].index].pass;
+		setPassState(pass);
+
+		OGPUTimerScope gpuScope(gpuPass[pass]);
+		const Item* prev = NULL;
+		for (; i < _order.size() && _items[_order[i].index].pass == pass; i++) {
+			const Item& item = _items[_order[i].index];
+
+			/* items that don't tell their program and mesh are assumed to bind their own state */
+			bool stateBound = (prev != NULL && item.mesh != 0 && item.program == prev->program &&
+					   item.mesh == prev->mesh);
+			if (!stateBound) _stateChanges++;
+			item.object->renderItem(item, stateBound);
+			prev = &item;
+		}
+	}
+
+	/* leaving the default pass state behind: bindings are left as they are, since OGLState tracks them */
+	setPassState(Pass_Opaque);
+}
+
+int ORenderQueue::stateChanges() const
+{
+	return _stateChanges;
+}
+
+ORenderQueue::SortKey ORenderQueue::sortKey(Pass pass, unsigned int program, unsigned int mesh, float depth,
+					     unsigned int sequence)
+{
+	/*
+	 * key layout, most significant bits first:
+	 *   opaque:  pass (2) | program (14) | mesh (16) | depth (32)
+	 *   blended: pass (2) | inverted depth (32) | program (14) | mesh (16)
+	 *   overlay: pass (2) | unused (30) | sequence (32)
+	 * program and mesh references are truncated: collisions only make the grouping less effective.
+	 */
+	SortKey key = (SortKey)pass << 62;
+	switch (pass) {
+	case Pass_Opaque:
+		key |= (SortKey)(program & 0x3fff) << 48 | (SortKey)(mesh & 0xffff) << 32 | depthBits(depth);
+		break;
+	case Pass_Blended:
+		key |= (SortKey)(~depthBits(depth)) << 30 | (SortKey)(program & 0x3fff) << 16 | (mesh & 0xffff);
+		break;
+	default:
+		key |= sequence;
+		break;
+	}
+	return key;
+}
+
+void ORenderQueue::setPassState(Pass pass)
+{
+	if (pass == Pass_Opaque) {
+		OGLState::disable(GL_BLEND);
+		OGLState::depthMask(GL_TRUE);
+	} else {
+		OGLState::enable(GL_BLEND);
+		OGLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		OGLState::depthMask(GL_FALSE);
+	}
+}
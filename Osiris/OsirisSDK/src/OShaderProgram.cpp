@@ -1,10 +1,14 @@
+#include <string.h>
+
+#include "OsirisSDK/OGLState.h"
 #include "OsirisSDK/OException.h"
 #include "OsirisSDK/OShaderProgram.h"
 
 using namespace std;
 
 OShaderProgram::OShaderProgram(const char* name) :
-	_programName(name)
+	_programName(name),
+	_linked(false)
 {
 	_program = glCreateProgram();
 	if (_program == 0) throw OException("Failed to create shader program.");
@@ -12,7 +16,7 @@ OShaderProgram::OShaderProgram(const char* name) :
 
 OShaderProgram::~OShaderProgram()
 {
-	glDeleteProgram(_program);
+	OGLState::deleteProgram(_program);
 }
 
 GLuint OShaderProgram::glReference() const
@@ -36,12 +40,57 @@ void OShaderProgram::addShader(OShaderObject::ShaderType type, const char* name,
 
 GLuint OShaderProgram::uniformLocation(const char * uniform_name)
 {
-	return glGetUniformLocation(_program, (const GLchar*)uniform_name);
+	return (GLuint)_uniforms[uniformHandle(uniform_name)].location;
 }
 
 GLuint OShaderProgram::attribLocation(const char * attrib_name)
 {
-	return glGetAttribLocation(_program, (const GLchar*)attrib_name);
+	unordered_map<string, GLint>::const_iterator it = _attribLocations.find(attrib_name);
+	if (it == _attribLocations.end()) return (GLuint)-1;
+	return it->second;
+}
+
+OShaderProgram::UniformHandle OShaderProgram::uniformHandle(const char * uniform_name)
+{
+	unordered_map<string, UniformHandle>::const_iterator it = _uniformHandles.find(uniform_name);
+	if (it != _uniformHandles.end()) return it->second;
+
+	/* names that were not reflected, such as array elements ("lights[2]") and struct members, are resolved by
+	   the driver, once: if the program is not linked yet, that is done when linking */
+	Uniform uniform;
+	uniform.location = (_linked) ? glGetUniformLocation(_program, uniform_name) : -1;
+	uniform.shadowValid = false;
+	UniformHandle handle = (UniformHandle)_uniforms.size();
+	_uniforms.push_back(uniform);
+	_uniformHandles[uniform_name] = handle;
+	return handle;
+}
+
+void OShaderProgram::setUniform(UniformHandle handle, GLint value)
+{
+	if (changed(handle, &value, sizeof(value))) glUniform1i(_uniforms[handle].location, value);
+}
+
+void OShaderProgram::setUniform(UniformHandle handle, GLfloat value)
+{
+	if (changed(handle, &value, sizeof(value))) glUniform1f(_uniforms[handle].location, value);
+}
+
+void OShaderProgram::setUniform(UniformHandle handle, const OVector3 & value)
+{
+	if (changed(handle, value.glArea(), 3 * sizeof(GLfloat))) glUniform3fv(_uniforms[handle].location, 1, value.glArea());
+}
+
+void OShaderProgram::setUniform(UniformHandle handle, const OVector4 & value)
+{
+	if (changed(handle, value.glArea(), 4 * sizeof(GLfloat))) glUniform4fv(_uniforms[handle].location, 1, value.glArea());
+}
+
+void OShaderProgram::setUniform(UniformHandle handle, const OMatrix4x4 & value)
+{
+	if (changed(handle, value.glArea(), 16 * sizeof(GLfloat))) {
+		glUniformMatrix4fv(_uniforms[handle].location, 1, GL_FALSE, value.glArea());
+	}
 }
 
 void OShaderProgram::compile()
@@ -68,9 +117,73 @@ void OShaderProgram::compile()
 		string errMsg = "Shader link error [" + _programName + "]: " + strInfoLog;
 		throw OException(errMsg.c_str());
 	}
+
+	reflect();
 }
 
 void OShaderProgram::use()
 {
-	glUseProgram(_program);
+	OGLState::useProgram(_program);
+}
+
+void OShaderProgram::reflect()
+{
+	GLint count, maxLength;
+	vector<GLchar> name;
+
+	/* linking resets uniform values: handles resolved so far are kept, but their locations and shadows are reset */
+	for (vector<Uniform>::iterator it = _uniforms.begin(); it != _uniforms.end(); it++) {
+		it->location = -1;
+		it->shadowValid = false;
+	}
+
+	glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+	name.resize(maxLength + 1);
+	for (GLint i = 0; i < count; i++) {
+		GLint size;
+		GLenum type;
+		glGetActiveUniform(_program, i, (GLsizei)name.size(), NULL, &size, &type, &name[0]);
+
+		/* arrays are reported as "name[0]": they are reachable by their plain name as well */
+		GLint location = glGetUniformLocation(_program, &name[0]);
+		if (location < 0) continue;		/* uniform block members */
+		string uniformName(&name[0]);
+		size_t bracket = uniformName.find('[');
+		if (bracket != string::npos) uniformName.erase(bracket);
+		_uniforms[uniformHandle(uniformName.c_str())].location = location;
+	}
+
+	/* handles of names that were not reflected are resolved by the driver */
+	for (unordered_map<string, UniformHandle>::iterator it = _uniformHandles.begin(); it != _uniformHandles.end(); it++) {
+		Uniform& uniform = _uniforms[it->second];
+		if (uniform.location < 0) uniform.location = glGetUniformLocation(_program, it->first.c_str());
+	}
+	_linked = true;
+
+	/* the camera uniform block is bound to the binding point where OCamera keeps its uniform buffer */
+	GLuint cameraBlock = glGetUniformBlockIndex(_program, OCAMERA_UNIFORMBLOCK_NAME);
+	if (cameraBlock != GL_INVALID_INDEX) glUniformBlockBinding(_program, cameraBlock, OCAMERA_UNIFORMBLOCK_BINDING);
+
+	_attribLocations.clear();
+	glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &count);
+	glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+	name.resize(maxLength + 1);
+	for (GLint i = 0; i < count; i++) {
+		GLint size;
+		GLenum type;
+		glGetActiveAttrib(_program, i, (GLsizei)name.size(), NULL, &size, &type, &name[0]);
+		_attribLocations[&name[0]] = glGetAttribLocation(_program, &name[0]);
+	}
+}
+
+bool OShaderProgram::changed(UniformHandle handle, const void * value, size_t size)
+{
+	if (handle < 0 || handle >= (UniformHandle)_uniforms.size()) return false;
+	Uniform& uniform = _uniforms[handle];
+	if (uniform.location < 0) return false;
+	if (uniform.shadowValid && memcmp(uniform.shadow, value, size) == 0) return false;
+	memcpy(uniform.shadow, value, size);
+	uniform.shadowValid = true;
+	return true;
 }
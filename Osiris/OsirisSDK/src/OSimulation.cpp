@@ -1,16 +1,36 @@
 #include "OsirisSDK/OEntity.h"
+#include "OsirisSDK/OMesh.h"
 #include "OsirisSDK/ORenderObject.h"
+#include "OsirisSDK/OProfiler.h"
+#include "OsirisSDK/OGPUTimer.h"
+#include "OsirisSDK/OOcclusionCuller.h"
+#include "OsirisSDK/OThreadPool.h"
 
 #include "OsirisSDK/OSimulation.h"
 
+using namespace std;
+
 OSimulation::OSimulation(const char * title, int argc, char ** argv, int windowPos_x, int windowPos_y, 
 			 int windowWidth, int windowHeight, int targetFPS, int simulationStep_us) :
-	OApplication(title, argc, argv, windowPos_x, windowPos_y, windowWidth, windowHeight, targetFPS, simulationStep_us)
+	OApplication(title, argc, argv, windowPos_x, windowPos_y, windowWidth, windowHeight, targetFPS, simulationStep_us),
+	_instancedRendering(true),
+	_instanceBatchCount(0),
+	_frustumCulling(true),
+	_visibleCount(0),
+	_culledCount(0),
+	_entitiesRevision(0),
+	_visibilityRevision(0),
+	_staticEntitiesValid(false),
+	_occlusionCuller(NULL),
+	_occlusionCulling(false),
+	_occludedCount(0),
+	_occlusionTested(0)
 {
 }
 
 OSimulation::~OSimulation()
 {
+	if (_occlusionCuller != NULL) delete _occlusionCuller;
 }
 
 OCollection<OEntity>* OSimulation::entities()
@@ -23,17 +43,50 @@ OCollection<ORenderObject>* OSimulation::renderObjects()
 	return &_renderObjects;
 }
 
+void OSimulation::setInstancedRendering(bool enabled)
+{
+	_instancedRendering = enabled;
+	_instanceBatches.clear();
+	_instanceBatchIndex.clear();
+	_instanceBatchCount = 0;
+}
+
+bool OSimulation::instancedRendering() const
+{
+	return _instancedRendering;
+}
+
 void OSimulation::update(const OTimeIndex & timeIndex, int step_us)
 {
+	OPROFILE_ZONE("OSimulation::update");
+
 	/* first we equalize states... */
+	equalizeStates();
+	/* ...then we update each entity state... */
+	updateStates(timeIndex, step_us);
+	/* ...and finally we swap the states */
+	swapStates(timeIndex, step_us);
+}
+
+void OSimulation::equalizeStates()
+{
+	OPROFILE_ZONE("OSimulation::equalizeState");
 	for (OCollection<OEntity>::Iterator it = entities()->begin(); it != entities()->end(); it++) {
 		it.object()->equalizeState();
 	}
-	/* ...then we update each entity state... */
+}
+
+void OSimulation::updateStates(const OTimeIndex & timeIndex, int step_us)
+{
+	OPROFILE_ZONE("OSimulation::updateState");
 	for (OCollection<OEntity>::Iterator it = entities()->begin(); it != entities()->end(); it++) {
 		it.object()->update(timeIndex, step_us);
 	}
-	/* ...and finally we swap the states */
+}
+
+void OSimulation::swapStates(const OTimeIndex & timeIndex, int step_us)
+{
+	OPROFILE_ZONE("OSimulation::swapState");
 	for (OCollection<OEntity>::Iterator it = entities()->begin(); it != entities()->end(); it++) {
 		it.object()->swapState(timeIndex, step_us);
 	}
@@ -41,13 +94,313 @@ void OSimulation::update(const OTimeIndex & timeIndex, int step_us)
 
 void OSimulation::render()
 {
-	OMatrixStack mtxTransform(*camera()->transform());
-	/* render entities */
+	OPROFILE_ZONE("OSimulation::render");
+
+	/* the camera matrices are updated once per frame and read by the shaders from the camera uniform buffer:
+	   objects are submitted with their model transformations only */
+	camera()->transform();
+	OMatrixStack mtxTransform;
+	_renderQueue.clear();
+	_renderQueue.setViewProjection(camera()->viewProjectionMatrix());
+
+	cullEntities();
+	if (_occlusionCulling) occlusionCullEntities();
+
+	/* entities first and then other objects, as the queue keeps the submission order of overlay items */
+	{
+		OPROFILE_ZONE("OSimulation::submit");
+		if (_instancedRendering) {
+			submitEntitiesInstanced(&mtxTransform);
+		} else {
+			for (vector<OEntity*>::iterator it = _visibleEntities.begin(); it != _visibleEntities.end(); it++) {
+				(*it)->submit(&_renderQueue, &mtxTransform);
+			}
+		}
+
+		/* there are usually few render objects: they are tested one by one */
+		const OFrustum& frustum = camera()->frustum();
+		for (OCollection<ORenderObject>::Iterator it = renderObjects()->begin(); it != renderObjects()->end(); it++) {
+			ORenderObject* obj = it.object();
+			if (obj->isHidden()) continue;
+			OVector3 center;
+			float radius;
+			if (_frustumCulling && obj->boundingSphere(center, radius) && !frustum.intersects(center, radius)) {
+				_culledCount++;
+				continue;
+			}
+			_visibleCount++;
+			obj->submit(&_renderQueue, &mtxTransform);
+		}
+	}
+
+	_renderQueue.sort();
+	_renderQueue.execute();
+}
+
+void OSimulation::setFrustumCulling(bool enabled)
+{
+	_frustumCulling = enabled;
+}
+
+bool OSimulation::frustumCulling() const
+{
+	return _frustumCulling;
+}
+
+void OSimulation::setOcclusionCulling(bool enabled)
+{
+	_occlusionCulling = enabled;
+	_occludedCount = 0;
+	_occlusionTested = 0;
+	if (enabled && _occlusionCuller == NULL) _occlusionCuller = new OOcclusionCuller();
+}
+
+bool OSimulation::occlusionCulling() const
+{
+	return _occlusionCulling;
+}
+
+OOcclusionCuller * OSimulation::occlusionCuller()
+{
+	return _occlusionCuller;
+}
+
+void OSimulation::invalidateStaticEntities()
+{
+	_staticEntitiesValid = false;
+}
+
+int OSimulation::staticEntityCount() const
+{
+	return _staticEntities.itemCount();
+}
+
+int OSimulation::visibleCount() const
+{
+	return _visibleCount;
+}
+
+int OSimulation::culledCount() const
+{
+	return _culledCount;
+}
+
+int OSimulation::occludedCount() const
+{
+	return _occludedCount;
+}
+
+float OSimulation::occlusionRejectionRate() const
+{
+	return (_occlusionTested > 0) ? (float)_occludedCount / _occlusionTested : 0.0f;
+}
+
+const ORenderQueue & OSimulation::renderQueue() const
+{
+	return _renderQueue;
+}
+
+void OSimulation::registerMetrics(OMetricsExporter * exporter)
+{
+	OApplication::registerMetrics(exporter);
+	exporter->addMetric("entities", [this]() { return (double)entities()->count(); });
+	exporter->addMetric("renderObjects", [this]() { return (double)renderObjects()->count(); });
+	exporter->addMetric("visibleObjects", [this]() { return (double)_visibleCount; });
+	exporter->addMetric("culledObjects", [this]() { return (double)_culledCount; });
+	exporter->addMetric("occludedObjects", [this]() { return (double)_occludedCount; });
+	exporter->addMetric("occlusionRejectionRate", [this]() { return (double)occlusionRejectionRate(); });
+	exporter->addMetric("staticEntities", [this]() { return (double)_staticEntities.itemCount(); });
+	exporter->addMetric("renderItems", [this]() { return (double)_renderQueue.itemCount(); });
+	exporter->addMetric("renderStateChanges", [this]() { return (double)_renderQueue.stateChanges(); });
+}
+
+void OSimulation::cullEntities()
+{
+	OPROFILE_ZONE("OSimulation::cull");
+
+	_visibleEntities.clear();
+	_cullEntities.clear();
+	_cullX.clear();
+	_cullY.clear();
+	_cullZ.clear();
+	_cullRadius.clear();
+	_culledCount = 0;
+
+	if (!_frustumCulling) {
+		for (OCollection<OEntity>::Iterator it = entities()->begin(); it != entities()->end(); it++) {
+			OEntity* entity = it.object();
+			if (!entity->isHidden() && entity->mesh() != NULL) _visibleEntities.push_back(entity);
+		}
+		_visibleCount = (int)_visibleEntities.size();
+		return;
+	}
+
+	if (!_staticEntitiesValid || _entities.revision() != _entitiesRevision ||
+	    OEntity::visibilityRevision() != _visibilityRevision) classifyEntities();
+	const OFrustum& frustum = camera()->frustum();
+
+	/* static entities: whole subtrees of the hierarchy are rejected or accepted at once */
+	_staticVisible.clear();
+	_staticEntities.cull(frustum, _staticVisible);
+	_culledCount += _staticEntities.itemCount() - (int)_staticVisible.size();
+	_visibleEntities.insert(_visibleEntities.end(), _staticVisible.begin(), _staticVisible.end());
+
+	/* dynamic entities: entities without bounds are never culled */
+	for (vector<OEntity*>::iterator it = _dynamicEntities.begin(); it != _dynamicEntities.end(); it++) {
+		OEntity* entity = *it;
+		if (entity->isHidden() || entity->mesh() == NULL) continue;
+
+		OVector3 center;
+		float radius;
+		if (!entity->boundingSphere(center, radius)) {
+			_visibleEntities.push_back(entity);
+			continue;
+		}
+		_cullEntities.push_back(entity);
+		_cullX.push_back(center.x());
+		_cullY.push_back(center.y());
+		_cullZ.push_back(center.z());
+		_cullRadius.push_back(radius);
+	}
+
+	int count = (int)_cullEntities.size();
+	if (count > 0) {
+		_cullVisible.resize(count);
+		frustum.intersects(&_cullX[0], &_cullY[0], &_cullZ[0], &_cullRadius[0], count, &_cullVisible[0]);
+		for (int i = 0; i < count; i++) {
+			if (_cullVisible[i]) _visibleEntities.push_back(_cullEntities[i]);
+			else _culledCount++;
+		}
+	}
+	_visibleCount = (int)_visibleEntities.size();
+}
+
+void OSimulation::occlusionCullEntities()
+{
+	OPROFILE_ZONE("OSimulation::occlusionCull");
+
+	_occludedCount = 0;
+	_occlusionTested = 0;
+
+	/* occluders of the visible entities are rasterized: entities hidden by the frustum can't hide others */
+	_occlusionCuller->begin(camera()->viewProjectionMatrix());
+	OMatrixStack model;
+	for (vector<OEntity*>::iterator it = _visibleEntities.begin(); it != _visibleEntities.end(); it++) {
+		OEntity* entity = *it;
+		if (entity->occluder() == NULL) continue;
+		model.push();
+		entity->transform(&model);
+		_occlusionCuller->addOccluder(entity->occluder(), model.top());
+		model.pop();
+	}
+	if (_occlusionCuller->triangleCount() == 0) return;
+	_occlusionCuller->rasterize(threadPool());
+
+	/* candidates reuse the frustum culling arrays, which are no longer needed on this frame */
+	_cullEntities.clear();
+	_cullX.clear();
+	_cullY.clear();
+	_cullZ.clear();
+	_cullRadius.clear();
+	for (vector<OEntity*>::iterator it = _visibleEntities.begin(); it != _visibleEntities.end(); it++) {
+		OEntity* entity = *it;
+		OVector3 center;
+		float radius;
+		if (entity->occluder() != NULL || !entity->boundingSphere(center, radius)) continue;
+		_cullEntities.push_back(entity);
+		_cullX.push_back(center.x());
+		_cullY.push_back(center.y());
+		_cullZ.push_back(center.z());
+		_cullRadius.push_back(radius);
+	}
+
+	_occlusionTested = (int)_cullEntities.size();
+	if (_occlusionTested == 0) return;
+	_occluded.assign(_occlusionTested, 0);
+	threadPool()->parallelFor(_occlusionTested, OSIMULATION_OCCLUSIONTEST_CHUNKSIZE, [this](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			_occluded[i] = _occlusionCuller->isOccluded(OVector3(_cullX[i], _cullY[i], _cullZ[i]), _cullRadius[i]);
+		}
+	});
+
+	/* candidates keep the order of the visible entities, so they are removed in a single pass */
+	size_t kept = 0;
+	int candidate = 0;
+	for (size_t i = 0; i < _visibleEntities.size(); i++) {
+		OEntity* entity = _visibleEntities[i];
+		if (candidate < _occlusionTested && _cullEntities[candidate] == entity) {
+			if (_occluded[candidate++]) {
+				_occludedCount++;
+				continue;
+			}
+		}
+		_visibleEntities[kept++] = entity;
+	}
+	_visibleEntities.resize(kept);
+	_visibleCount = (int)kept;
+}
+
+void OSimulation::classifyEntities()
+{
+	OPROFILE_ZONE("OSimulation::classifyEntities");
+
+	_staticEntities.clear();
+	_dynamicEntities.clear();
 	for (OCollection<OEntity>::Iterator it = entities()->begin(); it != entities()->end(); it++) {
-		it.object()->render(&mtxTransform);
+		OEntity* entity = it.object();
+		OVector3 center;
+		float radius;
+		/* hidden entities are kept out, so that they are counted as neither visible nor culled, as on the
+		   dynamic path: showing them rebuilds the hierarchy */
+		if (!entity->isHidden() && entity->isStatic() && entity->boundingSphere(center, radius)) {
+			_staticEntities.add(entity, center, radius);
+		} else {
+			_dynamicEntities.push_back(entity);
+		}
+	}
+	_staticEntities.build();
+
+	_entitiesRevision = _entities.revision();
+	_visibilityRevision = OEntity::visibilityRevision();
+	_staticEntitiesValid = true;
+}
+
+void OSimulation::submitEntitiesInstanced(OMatrixStack * mtx)
+{
+	/* batch slots are kept from frame to frame to reuse their storage, and only reset here, as the queue reads
+	   the matrices when it is executed. Slots are handed out in the order meshes are first seen. */
+	_instanceBatchIndex.clear();
+	_instanceBatchCount = 0;
+
+	/* grouping visible entities by mesh, along with their model matrices */
+	OMatrixStack model;
+	for (vector<OEntity*>::iterator eit = _visibleEntities.begin(); eit != _visibleEntities.end(); eit++) {
+		OEntity* entity = *eit;
+
+		unordered_map<OMesh*, int>::iterator idx = _instanceBatchIndex.find(entity->mesh());
+		if (idx == _instanceBatchIndex.end()) {
+			if (_instanceBatchCount == (int)_instanceBatches.size()) _instanceBatches.push_back(InstanceBatch());
+			InstanceBatch& slot = _instanceBatches[_instanceBatchCount];
+			slot.mesh = entity->mesh();
+			slot.first = entity;
+			slot.count = 0;
+			slot.matrices.clear();
+			idx = _instanceBatchIndex.insert(make_pair(entity->mesh(), _instanceBatchCount++)).first;
+		}
+		InstanceBatch& batch = _instanceBatches[idx->second];
+		batch.count++;
+
+		model.push();
+		entity->transform(&model);
+		OMatrix4x4 modelMtx = model.top();
+		batch.matrices.insert(batch.matrices.end(), modelMtx.glArea(), modelMtx.glArea() + 16);
+		model.pop();
 	}
-	/* render other objects */
-	for (OCollection<ORenderObject>::Iterator it = renderObjects()->begin(); it != renderObjects()->end(); it++) {
-		it.object()->render(&mtxTransform);
+
+	/* one item per mesh: single instances are submitted as usual, sparing the matrix upload */
+	for (int i = 0; i < _instanceBatchCount; i++) {
+		InstanceBatch& batch = _instanceBatches[i];
+		if (batch.count == 1) batch.first->submit(&_renderQueue, mtx);
+		else batch.mesh->submitInstanced(&_renderQueue, mtx, &batch.matrices[0], batch.count);
 	}
 }
@@ -245,6 +245,15 @@ int OState::validateConstraints(OVector3::Axis axis, int compIdx, float value)
 	return 0;
 }
 
+bool OState::isMotionless() const
+{
+	for (size_t i = 0; i < _components.size(); i++) {
+		const OVector3& c = _components[i];
+		if (c.x() != 0.0f || c.y() != 0.0f || c.z() != 0.0f) return false;
+	}
+	return true;
+}
+
 void OState::checkDegree(int degree)
 {
 	int currComponentsSize = _components.size();
@@ -6,6 +6,8 @@
 #include "OsirisSDK/OText2D.h"
 #include "OsirisSDK/OApplication.h"
 #include "OsirisSDK/OException.h"
+#include "OsirisSDK/OProfiler.h"
+#include "OsirisSDK/OGLState.h"
 
 #include "resource.h"
 
@@ -14,10 +16,10 @@ using namespace std;
 bool OText2D::_initialized = false;
 OShaderProgram* OText2D::_shaderProgram = NULL;
 GLuint OText2D::_shaderCoordAttr;
-GLuint OText2D::_shaderTexUniform;
-GLuint OText2D::_shaderColorUniform;
-GLuint OText2D::_shaderPosition;
-GLuint OText2D::_shaderScale;
+OShaderProgram::UniformHandle OText2D::_shaderTexUniform;
+OShaderProgram::UniformHandle OText2D::_shaderColorUniform;
+OShaderProgram::UniformHandle OText2D::_shaderPosition;
+OShaderProgram::UniformHandle OText2D::_shaderScale;
 
 OText2D::OText2D(OFont* font, unsigned int fontSize, float x, float y, const OVector4& color,
 		 const char* content) :
@@ -37,12 +39,15 @@ OText2D::OText2D(OFont* font, unsigned int fontSize, float x, float y, const OVe
 
 	OApplication::activeInstance()->addEventRecipient(OEvent::ResizeEvent, this);
 	
+	/* the attribute array is enabled once, as it is part of the vertex array object state */
 	glGenVertexArrays(1, &_arrayObject);
+	OGLState::bindVertexArray(_arrayObject);
+	glEnableVertexAttribArray(_shaderCoordAttr);
 }
 
 OText2D::~OText2D()
 {
-	glDeleteVertexArrays(1, &_arrayObject);
+	OGLState::deleteVertexArrays(1, &_arrayObject);
 }
 
 void OText2D::setFont(OFont * font, unsigned int fontSize)
@@ -132,25 +137,42 @@ void OText2D::render(OMatrixStack* mtx)
 {
 	if (isHidden()) return;
 
+	/* text is blended: the previous blending state is restored afterwards */
+	bool blend = OGLState::isEnabled(GL_BLEND);
+	OGLState::enable(GL_BLEND);
+	OGLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	renderText();
+	if (!blend) OGLState::disable(GL_BLEND);
+}
+
+void OText2D::submit(ORenderQueue * queue, OMatrixStack * stack)
+{
+	if (isHidden()) return;
+	queue->submit(this, stack->top(), ORenderQueue::Pass_Overlay, _shaderProgram->glReference(), _arrayObject);
+}
+
+void OText2D::renderItem(const ORenderQueue::Item &, bool)
+{
+	/* blending is set by the overlay pass */
+	renderText();
+}
+
+void OText2D::renderText()
+{
+	OPROFILE_ZONE("OText2D::render");
+
 	/* enabling array object */
-	glBindVertexArray(_arrayObject);
+	OGLState::bindVertexArray(_arrayObject);
 
 	/* we use the specific shader program */
 	_shaderProgram->use();
 
-	/* enable blending */
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
 	/* let us define the texture that will hold the glyph */
-	glUniform1i(_shaderTexUniform, 0);
-
-	/* now we enable attribute array and prepare the vertex array buffer */
-	glEnableVertexAttribArray(_shaderCoordAttr);
+	_shaderProgram->setUniform(_shaderTexUniform, (GLint)0);
 
 	/* set font color */
-	glUniform4fv(_shaderColorUniform, 1, _fontColor.glArea());
-	glUniform3fv(_shaderScale, 1, OVector3(_scale_x, _scale_y, 0.0f).glArea());
+	_shaderProgram->setUniform(_shaderColorUniform, _fontColor);
+	_shaderProgram->setUniform(_shaderScale, OVector3(_scale_x, _scale_y, 0.0f));
 
 	/* now we iterate through every character and render */
 	float currX = _x;
@@ -168,14 +190,14 @@ void OText2D::render(OMatrixStack* mtx)
 		if (fEntry == NULL) throw OException("Failed to load full font charset.");
 
 		/* Activate the texture unit 0 and bind the font texture */ 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, fEntry->texId);
+		OGLState::activeTexture(GL_TEXTURE0);
+		OGLState::bindTexture(GL_TEXTURE_2D, fEntry->texId);
 
 		/* passing shader uniform parameter: translation */
-		glUniform3fv(_shaderPosition, 1, OVector3(currX, currY, 0.0f).glArea());
+		_shaderProgram->setUniform(_shaderPosition, OVector3(currX, currY, 0.0f));
 		
 		/* binding buffer */
-		glBindBuffer(GL_ARRAY_BUFFER, fEntry->arrBufId);
+		OGLState::bindBuffer(GL_ARRAY_BUFFER, fEntry->arrBufId);
 		glVertexAttribPointer(_shaderCoordAttr, 4, GL_FLOAT, GL_FALSE, 0, 0);
 
 		/* draw */
@@ -185,10 +207,6 @@ void OText2D::render(OMatrixStack* mtx)
 		currX += (fEntry->advance_x >> 6) * _scale_x;
 		currY += (fEntry->advance_y >> 6) * _scale_y;
 	}
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glDisableVertexAttribArray(_shaderCoordAttr);
-	glBindVertexArray(0);
 }
 
 void OText2D::onScreenResize(const OResizeEvent * evt)
@@ -210,10 +228,10 @@ void OText2D::_Init()
 		_shaderProgram->compile();
 
 		_shaderCoordAttr = _shaderProgram->attribLocation("position");
-		_shaderTexUniform = _shaderProgram->uniformLocation("tex");
-		_shaderColorUniform = _shaderProgram->uniformLocation("color");
-		_shaderPosition = _shaderProgram->uniformLocation("posOffset");
-		_shaderScale = _shaderProgram->uniformLocation("scale");
+		_shaderTexUniform = _shaderProgram->uniformHandle("tex");
+		_shaderColorUniform = _shaderProgram->uniformHandle("color");
+		_shaderPosition = _shaderProgram->uniformHandle("posOffset");
+		_shaderScale = _shaderProgram->uniformHandle("scale");
 		
 		//if (_shaderCoordAttr == -1 || _shaderTexUniform == -1 || _shaderColorUniform == -1)
 		//	throw OException("Error accessing text shader parameters.");
@@ -0,0 +1,89 @@
+#include <algorithm>
+
+#include "OsirisSDK/OThreadPool.h"
+
+using namespace std;
+
+OThreadPool::OThreadPool(int threadCount) :
+	_task(NULL),
+	_count(0),
+	_chunkSize(1),
+	_next(0),
+	_activeWorkers(0),
+	_generation(0),
+	_stop(false)
+{
+	if (threadCount <= 0) threadCount = (int)thread::hardware_concurrency() - 1;
+	for (int i = 0; i < threadCount; i++) _threads.push_back(thread(&OThreadPool::worker, this));
+}
+
+OThreadPool::~OThreadPool()
+{
+	{
+		lock_guard<mutex> lock(_mutex);
+		_stop = true;
+	}
+	_workCond.notify_all();
+	for (size_t i = 0; i < _threads.size(); i++) _threads[i].join();
+}
+
+int OThreadPool::threadCount() const
+{
+	return (int)_threads.size();
+}
+
+void OThreadPool::parallelFor(int count, int chunkSize, const Task & task)
+{
+	if (count <= 0) return;
+	if (chunkSize < 1) chunkSize = 1;
+
+	/* not worth waking up the workers */
+	if (_threads.empty() || count <= chunkSize) {
+		task(0, count);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(_mutex);
+		_task = &task;
+		_count = count;
+		_chunkSize = chunkSize;
+		_next.store(0);
+		_activeWorkers = (int)_threads.size();
+		_generation++;
+	}
+	_workCond.notify_all();
+
+	runChunks();
+
+	unique_lock<mutex> lock(_mutex);
+	_doneCond.wait(lock, [this] { return _activeWorkers == 0; });
+	_task = NULL;
+}
+
+void OThreadPool::worker()
+{
+	unsigned int seenGeneration = 0;
+	for (;;) {
+		{
+			unique_lock<mutex> lock(_mutex);
+			_workCond.wait(lock, [&] { return _stop || _generation != seenGeneration; });
+			if (_stop) return;
+			seenGeneration = _generation;
+		}
+
+		runChunks();
+
+		lock_guard<mutex> lock(_mutex);
+		if (--_activeWorkers == 0) _doneCond.notify_one();
+	}
+}
+
+void OThreadPool::runChunks()
+{
+	for (;;) {
+		int begin = _next.fetch_add(_chunkSize);
+		if (begin >= _count) break;
+		(*_task)(begin, min(begin + _chunkSize, _count));
+	}
+}
@@ -1,218 +1,99 @@
+#include <mutex>
+
 #include "OsirisSDK/OTimeIndex.h"
 
 #ifndef WIN32
-#include <sys/time.h>
+#include <time.h>
 #endif
 
-#ifdef WIN32
-LARGE_INTEGER OTimeIndex::_wFrequency;
-LARGE_INTEGER OTimeIndex::_wStartingStamp;
-#else
-OTimeIndex OTimeIndex::_uStartingStamp;
+#if defined(OTIMEINDEX_TSC) && !defined(_MSC_VER)
+#include <cpuid.h>
 #endif
 
+/* until init() runs, the origin is the one of the monotonic clock */
+long long OTimeIndex::_startingStamp_ns = 0;
+long long OTimeIndex::_startingTicks = 0;
+double OTimeIndex::_nsPerTick = 1.0;
+bool OTimeIndex::_tscClock = false;
+std::atomic<bool> OTimeIndex::_calibrated(false);
 
-OTimeIndex::OTimeIndex()
-{
-}
-
-OTimeIndex::OTimeIndex(int sec, int usec) :
-	_sec(sec),
-	_usec(usec)
-{
-}
-
-
-OTimeIndex::OTimeIndex(long long timeIndex_us)
-{
-	setTimeFromInteger(timeIndex_us);
-}
-
-OTimeIndex::~OTimeIndex()
-{
-}
-
-inline OTimeIndex OTimeIndex::operator-(const OTimeIndex & in) const
-{
-	OTimeIndex res(*this);
-	res.operator-=(in);
-	return res;
-}
-
-inline OTimeIndex OTimeIndex::operator-(int in) const
-{
-	return this->operator-(OTimeIndex(in));
-}
-
-inline OTimeIndex & OTimeIndex::operator-=(const OTimeIndex & in)
-{
-	_sec -= in._sec;
-	_usec -= in._usec;
-	if (_usec < 0) {
-		_sec--;
-		_usec = 1 - _usec;
-	}
-	return *this;
-}
-
-inline OTimeIndex & OTimeIndex::operator-=(int in)
-{
-	return operator-=(OTimeIndex(in));
-}
-
-inline OTimeIndex OTimeIndex::operator+(const OTimeIndex & in) const
-{
-	OTimeIndex res(*this);
-	res.operator+=(in);
-	return res;
-}
-
-inline OTimeIndex OTimeIndex::operator+(int in) const
-{
-	return operator+(OTimeIndex(in));
-}
-
-inline OTimeIndex & OTimeIndex::operator+=(const OTimeIndex & in)
-{
-	_sec += in._sec;
-	_usec += in._usec;
-	if (_usec > 1000000) {
-		_sec++;
-		_usec -= 1000000;
-	}
-	return *this;
-}
-
-inline OTimeIndex & OTimeIndex::operator+=(int in)
-{
-	return operator+=(OTimeIndex(in));
-}
-
-inline OTimeIndex & OTimeIndex::operator=(int in)
-{
-	setTimeFromInteger(in);
-	return *this;
-}
-
-inline bool OTimeIndex::operator<(const OTimeIndex & in) const
-{
-	if (_sec < in._sec) return true;
-	else if (_sec == in._sec && _usec < in._usec) return true;
-	return false;
-}
-
-inline bool OTimeIndex::operator<(int in) const
-{
-	return operator<(OTimeIndex(in));
-}
-
-inline bool OTimeIndex::operator>(const OTimeIndex & in) const
-{
-	if (_sec > in._usec) return true;
-	else if (_sec == _usec && _usec > in._usec) return true;
-	return false;
-}
-
-inline bool OTimeIndex::operator>(int in) const
-{
-	return operator>(OTimeIndex(in));
-}
-
-inline bool OTimeIndex::operator<=(const OTimeIndex & in) const
-{
-	if (_sec < in._sec) return true;
-	else if (_sec == in._sec && _usec <= in._usec) return true;
-	return false;
-}
-
-inline bool OTimeIndex::operator<=(int in) const
-{
-	return operator<=(OTimeIndex(in));
-}
-
-inline bool OTimeIndex::operator>=(const OTimeIndex & in) const
-{
-	if (_sec > in._usec) return true;
-	else if (_sec == _usec && _usec >= in._usec) return true;
-	return false;
-}
-
-inline bool OTimeIndex::operator>=(int in) const
-{
-	return operator>=(OTimeIndex(in));
-}
-
-inline bool OTimeIndex::operator==(const OTimeIndex & in) const
-{
-	return (_sec == in._sec && _usec == in._usec);
-}
-
-inline bool OTimeIndex::operator==(int in) const
-{
-	return (_sec * 1000000 + _usec == in);
-}
-
-inline bool OTimeIndex::operator!=(const OTimeIndex & in) const
-{
-	return (_sec != in._sec || _usec != in._usec);
-}
-
-inline bool OTimeIndex::operator!=(int in) const
-{
-	return !operator==(in);
-}
-
-void OTimeIndex::setValue(int sec, int uSec)
-{
-	_sec = sec;
-	_usec = uSec;
-}
-
-int OTimeIndex::sec() const
-{
-	return _sec;
-}
-
-int OTimeIndex::uSec() const
+void OTimeIndex::init()
 {
-	return _usec;
+	/* both origins are taken together, so that current() and fromTicks() share the same timeline */
+	long long startTicks = ticks();
+	_startingStamp_ns = monotonicNanoseconds();
+	_startingTicks = startTicks;
+}
+
+void OTimeIndex::calibrate()
+{
+	/* not done at load time: the calibration busy-waits, which must not happen while the library is loaded */
+	static std::once_flag once;
+	std::call_once(once, []() {
+#ifdef OTIMEINDEX_TSC
+		if (hasInvariantTSC()) {
+			/* calibrating the TSC frequency against the monotonic clock */
+			long long start_ns = monotonicNanoseconds();
+			long long startTicks = (long long)__rdtsc();
+			long long end_ns;
+			do {
+				end_ns = monotonicNanoseconds();
+			} while (end_ns - start_ns < OTIMEINDEX_TSC_CALIBRATION_US * 1000LL);
+			long long endTicks = (long long)__rdtsc();
+
+			if (endTicks > startTicks) {
+				/* the tick origin is placed on the current origin of the monotonic clock */
+				_nsPerTick = (double)(end_ns - start_ns) / (endTicks - startTicks);
+				_startingTicks = endTicks - (long long)((end_ns - _startingStamp_ns) / _nsPerTick);
+				_tscClock = true;
+			}
+		}
+#endif
+		if (!_tscClock) _startingTicks = _startingStamp_ns;
+		_calibrated.store(true, std::memory_order_release);
+	});
 }
 
-int OTimeIndex::toInt() const
+OTimeIndex OTimeIndex::current()
 {
-	return _sec*1000000 + _usec;
+	return fromNanoseconds(monotonicNanoseconds() - _startingStamp_ns);
 }
 
-void OTimeIndex::init()
+long long OTimeIndex::monotonicNanoseconds()
 {
 #ifdef WIN32
-	QueryPerformanceFrequency(&_wFrequency);
-	QueryPerformanceCounter(&_wStartingStamp);
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER stamp;
+	QueryPerformanceCounter(&stamp);
+	/* splitting the conversion so that the tick count times 10^9 does not overflow */
+	long long sec = stamp.QuadPart / frequency.QuadPart;
+	long long rem = stamp.QuadPart % frequency.QuadPart;
+	return sec * 1000000000LL + rem * 1000000000LL / frequency.QuadPart;
 #else
-	struct timeval tv;
-	gettimeofday(&tv);
-	_uStartingStamp.setValue(tv.tv_sec, tv.tv_usec);
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
 #endif
 }
 
-OTimeIndex OTimeIndex::current()
+bool OTimeIndex::hasInvariantTSC()
 {
-#ifdef WIN32
-	LARGE_INTEGER currStamp;
-	QueryPerformanceCounter(&currStamp);
-	long long diff = (currStamp.QuadPart - _wStartingStamp.QuadPart) * 1000000 / _wFrequency.QuadPart;
-	return OTimeIndex((long long)diff);
+#ifdef OTIMEINDEX_TSC
+	/* CPUID leaf 0x80000007, EDX bit 8: the TSC runs at a constant rate in all power states */
+	unsigned int regs[4] = { 0, 0, 0, 0 };
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0x80000000);
+	if ((unsigned int)info[0] < 0x80000007) return false;
+	__cpuid(info, 0x80000007);
+	regs[3] = (unsigned int)info[3];
 #else
-	OTimeStamp currStamp;
-	struct timeval tv;
-	gettimeofday(&tv);
-	currStamp.setValue(tv.tv_sec, tv.tv_usec);
-	return currStamp - _uStartingStamp;
+	if (__get_cpuid_max(0x80000000, 0) < 0x80000007) return false;
+	__get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+	return (regs[3] & (1 << 8)) != 0;
+#else
+	return false;
 #endif
-}
-
-void OTimeIndex::setTimeFromInteger(long long timeIndex)
-{
-	_sec = (int)(timeIndex / 1000000);
-	_usec = (int)(timeIndex % 1000000);
 }
@@ -0,0 +1,194 @@
+#include "OsirisSDK/OException.h"
+#include "OsirisSDK/OObject.h"
+
+#include "OsirisSDK/OTimerWheel.h"
+
+using namespace std;
+
+// ***********************************************************************
+// OTimerWheel::Handle
+// ***********************************************************************
+OTimerWheel::Handle::Handle() :
+	index(-1),
+	generation(0)
+{
+}
+
+// ***********************************************************************
+// OTimerWheel
+// ***********************************************************************
+OTimerWheel::OTimerWheel(int resolution_us) :
+	_freeList(-1),
+	_resolution_us(resolution_us),
+	_origin_us(0),
+	_currentTick(0),
+	_activeCount(0)
+{
+	if (resolution_us <= 0) throw OException("Invalid timer wheel resolution.");
+	for (int i = 0; i < OTIMERWHEEL_LEVELS * SlotCount; i++) _slots[i] = -1;
+}
+
+OTimerWheel::~OTimerWheel()
+{
+}
+
+int OTimerWheel::resolution() const
+{
+	return _resolution_us;
+}
+
+void OTimerWheel::start(const OTimeIndex & timeIndex)
+{
+	for (size_t i = 0; i < _timers.size(); i++) if (_timers[i].slot >= 0) release((int)i);
+	for (int i = 0; i < OTIMERWHEEL_LEVELS * SlotCount; i++) _slots[i] = -1;
+	_origin_us = timeIndex.toMicroseconds();
+	_currentTick = 0;
+}
+
+OTimerWheel::Handle OTimerWheel::schedule(OObject * target, int timerId, const OTimeIndex & timeIndex, int period_us)
+{
+	if (target == NULL) throw OException("Timer scheduled without a target object.");
+
+	/* taking a timer from the free list */
+	int idx = _freeList;
+	if (idx >= 0) {
+		_freeList = _timers[idx].next;
+	} else {
+		Timer timer;
+		timer.generation = 0;
+		_timers.push_back(timer);
+		idx = (int)_timers.size() - 1;
+	}
+
+	/* expiration is rounded up, so that timers never fire early */
+	long long offset_us = timeIndex.toMicroseconds() - _origin_us;
+	Timer& timer = _timers[idx];
+	timer.target = target;
+	timer.timerId = timerId;
+	timer.expires = (offset_us > 0) ? (offset_us + _resolution_us - 1) / _resolution_us : 0;
+	timer.period = (period_us > 0) ? ((long long)period_us + _resolution_us - 1) / _resolution_us : 0;
+	insert(idx, _currentTick + 1);
+	_activeCount++;
+
+	Handle handle;
+	handle.index = idx;
+	handle.generation = timer.generation;
+	return handle;
+}
+
+bool OTimerWheel::cancel(const Handle & handle)
+{
+	if (!isActive(handle)) return false;
+	release(handle.index);
+	return true;
+}
+
+void OTimerWheel::cancelAll(OObject * target)
+{
+	for (size_t i = 0; i < _timers.size(); i++) {
+		if (_timers[i].slot >= 0 && _timers[i].target == target) release((int)i);
+	}
+}
+
+bool OTimerWheel::isActive(const Handle & handle) const
+{
+	if (handle.index < 0 || handle.index >= (int)_timers.size()) return false;
+	const Timer& timer = _timers[handle.index];
+	return (timer.generation == handle.generation && timer.slot >= 0);
+}
+
+int OTimerWheel::activeCount() const
+{
+	return _activeCount;
+}
+
+void OTimerWheel::advance(const OTimeIndex & timeIndex)
+{
+	long long targetTick = (timeIndex.toMicroseconds() - _origin_us) / _resolution_us;
+	while (_currentTick < targetTick) {
+		long long tick = ++_currentTick;
+
+		/* moving timers down from the upper levels as their ranges come up */
+		for (int level = 1; level < OTIMERWHEEL_LEVELS; level++) {
+			if ((tick & ((1LL << (OTIMERWHEEL_SLOTBITS * level)) - 1)) != 0) break;
+			cascade(level, (int)((tick >> (OTIMERWHEEL_SLOTBITS * level)) & SlotMask));
+		}
+
+		/* firing: timers are taken one at a time since callbacks may cancel or schedule timers */
+		int slot = (int)(tick & SlotMask);
+		while (_slots[slot] >= 0) {
+			int idx = _slots[slot];
+			OObject *target = _timers[idx].target;
+			int timerId = _timers[idx].timerId;
+
+			if (_timers[idx].expires > tick) {
+				/* parked timer that has not come into range yet */
+				unlink(idx);
+				insert(idx, tick + 1);
+				continue;
+			}
+
+			if (_timers[idx].period > 0) {
+				unlink(idx);
+				_timers[idx].expires += _timers[idx].period;
+				insert(idx, tick + 1);
+			} else {
+				release(idx);
+			}
+
+			target->processTimer(timerId, timeIndex);
+		}
+	}
+}
+
+void OTimerWheel::insert(int idx, long long earliestTick)
+{
+	Timer& timer = _timers[idx];
+	long long expires = (timer.expires > earliestTick) ? timer.expires : earliestTick;
+	long long delta = expires - _currentTick;
+
+	/* finding the level whose range covers the expiration; timers beyond the wheel range are parked
+	   on the last slot it can reach */
+	int level = 0;
+	while (level < OTIMERWHEEL_LEVELS - 1 && delta >= (1LL << (OTIMERWHEEL_SLOTBITS * (level + 1)))) level++;
+	if (delta >= (1LL << (OTIMERWHEEL_SLOTBITS * OTIMERWHEEL_LEVELS))) {
+		expires = _currentTick + (1LL << (OTIMERWHEEL_SLOTBITS * OTIMERWHEEL_LEVELS)) - 1;
+	}
+
+	int slot = level * SlotCount + (int)((expires >> (OTIMERWHEEL_SLOTBITS * level)) & SlotMask);
+	timer.prev = -1;
+	timer.next = _slots[slot];
+	timer.slot = slot;
+	if (timer.next >= 0) _timers[timer.next].prev = idx;
+	_slots[slot] = idx;
+}
+
+void OTimerWheel::unlink(int idx)
+{
+	Timer& timer = _timers[idx];
+	if (timer.prev >= 0) _timers[timer.prev].next = timer.next;
+	else _slots[timer.slot] = timer.next;
+	if (timer.next >= 0) _timers[timer.next].prev = timer.prev;
+	timer.slot = -1;
+}
+
+void OTimerWheel::release(int idx)
+{
+	unlink(idx);
+	Timer& timer = _timers[idx];
+	timer.target = NULL;
+	timer.generation++;
+	timer.next = _freeList;
+	_freeList = idx;
+	_activeCount--;
+}
+
+void OTimerWheel::cascade(int level, int slotIdx)
+{
+	int slot = level * SlotCount + slotIdx;
+	while (_slots[slot] >= 0) {
+		int idx = _slots[slot];
+		unlink(idx);
+		insert(idx, _currentTick);
+	}
+}